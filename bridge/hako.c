@@ -24,8 +24,166 @@
 #define WASM_EXPORT(func) func
 #endif
 
+/**
+ * Value handle table. Every LEPUSValue returned to the host lives in a slot
+ * of a per-runtime slab instead of its own heap allocation. Slots are carved
+ * from fixed-size pages so their addresses stay stable for the lifetime of
+ * the runtime, and released slots are recycled through an intrusive free
+ * list. Each slot carries a generation counter, and a 32-bit handle
+ * (generation << HAKO_HANDLE_INDEX_BITS | index + 1) keeps its low 12 bits.
+ * That catches most uses of a released handle, but not all of them: the
+ * encoded generation repeats every 4096 releases of the same slot. The 20-bit
+ * index caps a runtime at HAKO_HANDLE_MAX_SLOTS (about 1M) live values; past
+ * that, boxing a value fails as if out of memory.
+ */
+#define HAKO_HANDLE_PAGE_BITS 10
+#define HAKO_HANDLE_PAGE_SIZE (1u << HAKO_HANDLE_PAGE_BITS)
+#define HAKO_HANDLE_INDEX_BITS 20
+#define HAKO_HANDLE_INDEX_MASK ((1u << HAKO_HANDLE_INDEX_BITS) - 1)
+#define HAKO_HANDLE_GENERATION_MASK ((1u << (32 - HAKO_HANDLE_INDEX_BITS)) - 1)
+#define HAKO_HANDLE_MAX_SLOTS (HAKO_HANDLE_INDEX_MASK - 1)
+#define HAKO_HANDLE_MAX_PAGES \
+  (1u << (HAKO_HANDLE_INDEX_BITS - HAKO_HANDLE_PAGE_BITS))
+#define HAKO_HANDLE_SLOT_NONE UINT32_MAX
+#define HAKO_HANDLE_SLOT_LIVE (UINT32_MAX - 1)
+
+typedef struct HakoHandleSlot {
+  LEPUSValue value;    // Must stay first, slots are handed out as LEPUSValue*
+  uint32_t index;      // Position of this slot in the table
+  uint32_t generation; // Bumped every time the slot is released
+  uint32_t next_free;  // Next free slot, or HAKO_HANDLE_SLOT_LIVE when in use
+  uint32_t scope;      // Value scope depth that owns the slot, 0 if unscoped
+  LEPUSContext* scope_ctx;  // Context whose scope stack the depth refers to
+} HakoHandleSlot;
+
+typedef struct HakoHandleTable {
+  HakoHandleSlot* pages[HAKO_HANDLE_MAX_PAGES];
+  uint32_t page_count;
+  uint32_t slot_count;  // Slots carved out of the pages so far
+  uint32_t live_count;
+  uint32_t free_head;
+  uint32_t open_scopes;  // Value scopes open across all contexts
+} HakoHandleTable;
+
+// Import resolved ahead of time through host_load_modules. The source is
+// handed over on the first load of the module; the entry then keeps
+// answering normalization requests for (base, specifier).
+typedef struct HakoPrefetchedModule {
+  struct HakoPrefetchedModule* next;
+  char* base;
+  char* specifier;
+  char* name;     // Normalized name reported by the host
+  char* source;   // NULL once loaded, or for repeated imports of a module
+  char* version;  // Optional, as in HakoModuleSource
+} HakoPrefetchedModule;
+
+// Global object property recorded by HAKO_SaveContextBaseline
+typedef struct HakoBaselineProperty {
+  LEPUSAtom atom;
+  LEPUSPropertyDescriptor desc;  // Owns value, getter and setter
+} HakoBaselineProperty;
+
+// Bridge state attached to a context. Kept in a list on the runtime because
+// the context opaque pointer belongs to the embedder (HAKO_SetContextData).
+typedef struct HakoContextState {
+  LEPUSContext* ctx;
+  struct HakoContextState* next;
+  LEPUSValue* scratch_argv;  // Reusable argv for the *Argv call exports
+  uint32_t scratch_argv_capacity;
+  HakoPrefetchedModule* prefetched;
+  HakoBaselineProperty* baseline;  // NULL until HAKO_SaveContextBaseline
+  uint32_t baseline_count;
+  // Value scopes: handles boxed for this context while a scope is open are
+  // appended to scope_log, and scope_marks remembers where each open scope
+  // starts.
+  uint32_t* scope_log;
+  uint32_t scope_log_len;
+  uint32_t scope_log_capacity;
+  uint32_t* scope_marks;
+  uint32_t scope_depth;
+  uint32_t scope_marks_capacity;
+} HakoContextState;
+
+#define HAKO_SCRATCH_ARGV_MAX 1024
+
+#ifdef ENABLE_CODECACHE
+#define HAKO_SCRIPT_CACHE_DEFAULT_LIMIT (8 * 1024 * 1024)
+#else
+#define HAKO_SCRIPT_CACHE_DEFAULT_LIMIT 0
+#endif
+
+// Compiled script kept in serialized form so that any context of the runtime
+// can instantiate it without parsing
+typedef struct HakoScriptCacheEntry {
+  struct HakoScriptCacheEntry* prev;  // Towards the most recently used
+  struct HakoScriptCacheEntry* next;
+  uint64_t hash;
+  char* source;  // Compared on lookup, since the hash is not collision-free
+  size_t source_len;
+  char* filename;
+  int eval_flags;
+  LEPUS_BOOL detect_module;
+  int strip_flags;  // HAKO_SetStripInfo flags the bytecode was compiled with
+  uint8_t* bytecode;
+  size_t bytecode_len;
+  size_t size;  // Bytes charged against the cache limit
+} HakoScriptCacheEntry;
+
+typedef struct HakoScriptCache {
+  HakoScriptCacheEntry* head;  // Most recently used
+  HakoScriptCacheEntry* tail;
+  HakoScriptCacheStats stats;
+} HakoScriptCache;
+
+// Bytecode bundle registered with HAKO_LoadBundle. Only the index is
+// validated up front; modules are read when an import first needs them.
+typedef struct HakoBundle {
+  struct HakoBundle* next;
+  uint8_t* data;  // Owned
+  uint32_t length;
+  uint32_t count;
+  // Open-addressed index by module name hash: entry index + 1, 0 if empty
+  uint32_t* slots;
+  uint32_t slot_mask;
+} HakoBundle;
+
+// Compiled module shared by every context of a runtime, keyed by the
+// normalized module name and the version the host reported for its source
+typedef struct HakoModuleCacheEntry {
+  struct HakoModuleCacheEntry* next;
+  char* name;
+  char* version;
+  uint8_t* bytecode;
+  size_t bytecode_len;
+} HakoModuleCacheEntry;
+
+// Module registered with HAKO_RegisterModuleBytecode or
+// HAKO_RegisterModuleSource
+typedef struct HakoRegisteredModule {
+  struct HakoRegisteredModule* next;  // Next in the same bucket
+  uint64_t hash;
+  char* name;
+  bool is_bytecode;
+  uint8_t* data;  // Bytecode, or null-terminated source
+  size_t length;
+} HakoRegisteredModule;
+
+typedef struct HakoModuleRegistry {
+  HakoRegisteredModule** buckets;
+  uint32_t bucket_count;  // Zero or a power of two
+  uint32_t count;
+} HakoModuleRegistry;
+
 typedef struct hako_RuntimeData {
   bool debug_log;
+  HakoHandleTable handles;
+  HakoContextState* contexts;
+  HakoScriptCache scripts;
+  HakoBundle* bundles;  // Most recently loaded first
+  HakoModuleCacheEntry* modules;
+  HakoModuleRegistry registry;
+  bool prefetch_modules;
+  bool module_loader;  // Whether hako_load_module is installed
 } hako_RuntimeData;
 
 typedef enum {
@@ -42,8 +200,18 @@ typedef struct HakoModuleSource {
     LEPUSModuleDef* module_def;  // Pointer to precompiled module (if type is
                                  // HAKO_MODULE_SOURCE_PRECOMPILED)
   } data;
+  char* version;  // Optional version or etag of source code; when set, the
+                  // compiled module is cached for every context
 } HakoModuleSource;
 
+// One result of host_load_modules. The host allocates every field with
+// HAKO_Malloc and leaves name or source NULL for specifiers it cannot load.
+typedef struct HakoModulePrefetch {
+  char* name;     // Normalized module name
+  char* source;   // Module source code
+  char* version;  // Optional, as in HakoModuleSource
+} HakoModulePrefetch;
+
 __attribute__((import_module("hako"),
                import_name("call_function"))) extern LEPUSValue*
 host_call_function(LEPUSContext* ctx, LEPUSValueConst* this_ptr, int argc,
@@ -58,6 +226,12 @@ __attribute__((import_module("hako"),
 host_load_module(LEPUSRuntime* rt, LEPUSContext* ctx, CString* module_name,
                  void* opaque, LEPUSValueConst* attributes);
 
+__attribute__((import_module("hako"),
+               import_name("load_modules"))) extern void
+host_load_modules(LEPUSRuntime* rt, LEPUSContext* ctx, uint32_t count,
+                  CString** base_names, CString** module_names,
+                  HakoModulePrefetch* out_results);
+
 __attribute__((import_module("hako"),
                import_name("normalize_module"))) extern char*
 host_normalize_module(LEPUSRuntime* rt, LEPUSContext* ctx,
@@ -204,9 +378,99 @@ static void hako_profile_function_end(LEPUSContext* ctx, JSAtom func,
   }
 }
 
+static HakoModuleCacheEntry* hako_module_cache_find(LEPUSRuntime* rt,
+                                                    CString* module_name,
+                                                    CString* version) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (!data) {
+    return NULL;
+  }
+  for (HakoModuleCacheEntry* entry = data->modules; entry;
+       entry = entry->next) {
+    if (strcmp(entry->name, module_name) == 0 &&
+        strcmp(entry->version, version) == 0) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+static void hako_module_cache_entry_free(LEPUSRuntime* rt,
+                                         HakoModuleCacheEntry* entry) {
+  lepus_free_rt(rt, entry->name);
+  lepus_free_rt(rt, entry->version);
+  lepus_free_rt(rt, entry->bytecode);
+  lepus_free_rt(rt, entry);
+}
+
+// Drops entries for module_name, or every entry when it is NULL
+static void hako_module_cache_invalidate(LEPUSRuntime* rt,
+                                         CString* module_name) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (!data) {
+    return;
+  }
+  HakoModuleCacheEntry** link = &data->modules;
+  while (*link) {
+    HakoModuleCacheEntry* entry = *link;
+    if (!module_name || strcmp(entry->name, module_name) == 0) {
+      *link = entry->next;
+      hako_module_cache_entry_free(rt, entry);
+    } else {
+      link = &entry->next;
+    }
+  }
+}
+
+static char* hako_strdup_rt(LEPUSRuntime* rt, const char* str) {
+  size_t size = strlen(str) + 1;
+  char* copy = lepus_malloc_rt(rt, size, ALLOC_TAG_WITHOUT_PTR);
+  if (copy) {
+    memcpy(copy, str, size);
+  }
+  return copy;
+}
+
+// Best effort: a module that cannot be cached still loads normally.
+// Older versions of the same module are replaced.
+static void hako_module_cache_store(LEPUSContext* ctx, CString* module_name,
+                                    CString* version,
+                                    LEPUSValueConst func_val) {
+  LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (!data) {
+    return;
+  }
+  size_t bytecode_len;
+  uint8_t* bytecode = LEPUS_WriteObject(ctx, &bytecode_len, func_val,
+                                        LEPUS_WRITE_OBJ_BYTECODE);
+  if (!bytecode) {
+    LEPUS_FreeValue(ctx, LEPUS_GetException(ctx));
+    return;
+  }
+  HakoModuleCacheEntry* entry = lepus_malloc_rt(
+      rt, sizeof(HakoModuleCacheEntry), ALLOC_TAG_WITHOUT_PTR);
+  if (!entry) {
+    lepus_free_rt(rt, bytecode);
+    return;
+  }
+  entry->name = hako_strdup_rt(rt, module_name);
+  entry->version = hako_strdup_rt(rt, version);
+  entry->bytecode = bytecode;
+  entry->bytecode_len = bytecode_len;
+  if (!entry->name || !entry->version) {
+    hako_module_cache_entry_free(rt, entry);
+    return;
+  }
+  hako_module_cache_invalidate(rt, module_name);
+  entry->next = data->modules;
+  data->modules = entry;
+}
+
 static LEPUSModuleDef* hako_compile_module(LEPUSContext* ctx,
                                            CString* module_name,
-                                           BorrowedHeapChar* module_body) {
+                                           BorrowedHeapChar* module_body,
+                                           CString* version) {
   // Use explicit flags for module compilation
   int eval_flags = LEPUS_EVAL_TYPE_MODULE | LEPUS_EVAL_FLAG_COMPILE_ONLY |
                    LEPUS_EVAL_FLAG_STRICT;
@@ -226,6 +490,10 @@ static LEPUSModuleDef* hako_compile_module(LEPUSContext* ctx,
     return NULL;
   }
 
+  if (version) {
+    hako_module_cache_store(ctx, module_name, version, func_val);
+  }
+
   // Set import.meta for this module - not main since it's loaded as a
   // dependency
   if (LEPUS_SetImportMeta(ctx, func_val, TRUE, FALSE) < 0) {
@@ -239,10 +507,829 @@ static LEPUSModuleDef* hako_compile_module(LEPUSContext* ctx,
   return module;
 }
 
+static uint64_t hako_hash_bytes(uint64_t hash, const void* data, size_t len) {
+  const uint8_t* bytes = data;
+  for (size_t i = 0; i < len; i++) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ULL;  // FNV-1a
+  }
+  return hash;
+}
+
+static inline uint64_t hako_module_name_hash(CString* name) {
+  return hako_hash_bytes(0xcbf29ce484222325ULL, name, strlen(name));
+}
+
+static inline uint32_t hako_bundle_u32(const uint8_t* p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static inline const uint8_t* hako_bundle_entry(const HakoBundle* bundle,
+                                               uint32_t index) {
+  return bundle->data + HAKO_BUNDLE_HEADER_SIZE +
+         index * HAKO_BUNDLE_ENTRY_SIZE;
+}
+
+static inline bool hako_bundle_range_ok(uint32_t length, uint32_t offset,
+                                        uint32_t size) {
+  return offset <= length && size <= length - offset;
+}
+
+// Checks the header and that every index entry points inside the bundle
+static bool hako_bundle_validate(HakoBundle* bundle) {
+  if (bundle->length < HAKO_BUNDLE_HEADER_SIZE ||
+      hako_bundle_u32(bundle->data) != HAKO_BUNDLE_MAGIC ||
+      hako_bundle_u32(bundle->data + 4) != HAKO_BUNDLE_VERSION) {
+    return false;
+  }
+  bundle->count = hako_bundle_u32(bundle->data + 8);
+  uint32_t index_space = bundle->length - HAKO_BUNDLE_HEADER_SIZE;
+  if (bundle->count > index_space / HAKO_BUNDLE_ENTRY_SIZE) {
+    return false;
+  }
+  for (uint32_t i = 0; i < bundle->count; i++) {
+    const uint8_t* entry = hako_bundle_entry(bundle, i);
+    if (!hako_bundle_range_ok(bundle->length, hako_bundle_u32(entry),
+                              hako_bundle_u32(entry + 4)) ||
+        !hako_bundle_range_ok(bundle->length, hako_bundle_u32(entry + 8),
+                              hako_bundle_u32(entry + 12))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static inline bool hako_bundle_entry_is(const HakoBundle* bundle,
+                                        const uint8_t* entry,
+                                        const char* name, size_t name_len) {
+  return hako_bundle_u32(entry + 4) == name_len &&
+         memcmp(bundle->data + hako_bundle_u32(entry), name, name_len) == 0;
+}
+
+// Returns the index slot holding name, or the empty slot where it belongs
+static uint32_t* hako_bundle_slot(const HakoBundle* bundle, const char* name,
+                                  size_t name_len) {
+  uint32_t i =
+      (uint32_t)hako_hash_bytes(0xcbf29ce484222325ULL, name, name_len) &
+      bundle->slot_mask;
+  while (bundle->slots[i] != 0 &&
+         !hako_bundle_entry_is(bundle,
+                               hako_bundle_entry(bundle, bundle->slots[i] - 1),
+                               name, name_len)) {
+    i = (i + 1) & bundle->slot_mask;
+  }
+  return &bundle->slots[i];
+}
+
+// Indexes the entries by name; a name listed twice resolves to the first
+static bool hako_bundle_index(LEPUSRuntime* rt, HakoBundle* bundle) {
+  uint32_t slot_count = 16;
+  while (slot_count / 2 < bundle->count) {
+    slot_count *= 2;
+  }
+  bundle->slots = lepus_malloc_rt(rt, slot_count * sizeof(uint32_t),
+                                  ALLOC_TAG_WITHOUT_PTR);
+  if (!bundle->slots) {
+    return false;
+  }
+  memset(bundle->slots, 0, slot_count * sizeof(uint32_t));
+  bundle->slot_mask = slot_count - 1;
+  for (uint32_t i = 0; i < bundle->count; i++) {
+    const uint8_t* entry = hako_bundle_entry(bundle, i);
+    const char* name = (const char*)bundle->data + hako_bundle_u32(entry);
+    uint32_t* slot =
+        hako_bundle_slot(bundle, name, hako_bundle_u32(entry + 4));
+    if (*slot == 0) {
+      *slot = i + 1;
+    }
+  }
+  return true;
+}
+
+static void hako_bundles_free(LEPUSRuntime* rt, hako_RuntimeData* data) {
+  while (data->bundles) {
+    HakoBundle* bundle = data->bundles;
+    data->bundles = bundle->next;
+    lepus_free_rt(rt, bundle->slots);
+    lepus_free_rt(rt, bundle->data);
+    lepus_free_rt(rt, bundle);
+  }
+}
+
+static bool hako_bundle_find(LEPUSRuntime* rt, CString* module_name,
+                             const uint8_t** out_bytecode,
+                             uint32_t* out_length) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (!data || !data->bundles) {
+    return false;
+  }
+  size_t name_len = strlen(module_name);
+  for (HakoBundle* bundle = data->bundles; bundle; bundle = bundle->next) {
+    uint32_t index = *hako_bundle_slot(bundle, module_name, name_len);
+    if (index != 0) {
+      const uint8_t* entry = hako_bundle_entry(bundle, index - 1);
+      *out_bytecode = bundle->data + hako_bundle_u32(entry + 8);
+      *out_length = hako_bundle_u32(entry + 12);
+      return true;
+    }
+  }
+  return false;
+}
+
+static LEPUSModuleDef* hako_read_module(LEPUSContext* ctx,
+                                        CString* module_name,
+                                        const uint8_t* bytecode,
+                                        uint32_t length) {
+  LEPUSValue func_val =
+      LEPUS_ReadObject(ctx, bytecode, length, LEPUS_READ_OBJ_BYTECODE);
+  if (LEPUS_IsException(func_val)) {
+    return NULL;
+  }
+  if (!LEPUS_VALUE_IS_MODULE(func_val)) {
+    LEPUS_ThrowTypeError(ctx, "Bytecode for '%s' is not a module",
+                         module_name);
+    LEPUS_FreeValue(ctx, func_val);
+    return NULL;
+  }
+  if (LEPUS_SetImportMeta(ctx, func_val, TRUE, FALSE) < 0) {
+    LEPUS_FreeValue(ctx, func_val);
+    return NULL;
+  }
+
+  LEPUSModuleDef* module = LEPUS_VALUE_GET_PTR(func_val);
+  LEPUS_FreeValue(ctx, func_val);
+  return module;
+}
+
+// Module registry
+//
+// Registered modules are looked up by name before any other source, so
+// libraries injected into every context load without calling the host.
+// Registered source is compiled once per runtime through the module cache.
+
+// Version under which compiled registered sources are kept in the module
+// cache; host versions are printable, so this cannot collide with them
+#define HAKO_REGISTERED_MODULE_VERSION "\x01registered"
+
+static HakoRegisteredModule** hako_registry_slot(HakoModuleRegistry* registry,
+                                                 CString* name,
+                                                 uint64_t hash) {
+  if (registry->bucket_count == 0) {
+    return NULL;
+  }
+  HakoRegisteredModule** link =
+      &registry->buckets[hash & (registry->bucket_count - 1)];
+  while (*link && ((*link)->hash != hash || strcmp((*link)->name, name))) {
+    link = &(*link)->next;
+  }
+  return link;
+}
+
+static HakoRegisteredModule* hako_registry_find(LEPUSRuntime* rt,
+                                                CString* name) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (!data || data->registry.count == 0) {
+    return NULL;
+  }
+  HakoRegisteredModule** slot =
+      hako_registry_slot(&data->registry, name, hako_module_name_hash(name));
+  return slot ? *slot : NULL;
+}
+
+static void hako_registered_module_free(LEPUSRuntime* rt,
+                                        HakoRegisteredModule* module) {
+  lepus_free_rt(rt, module->name);
+  lepus_free_rt(rt, module->data);
+  lepus_free_rt(rt, module);
+}
+
+static bool hako_registry_grow(LEPUSRuntime* rt,
+                               HakoModuleRegistry* registry) {
+  uint32_t bucket_count =
+      registry->bucket_count ? registry->bucket_count * 2 : 16;
+  HakoRegisteredModule** buckets =
+      lepus_malloc_rt(rt, bucket_count * sizeof(HakoRegisteredModule*),
+                      ALLOC_TAG_WITHOUT_PTR);
+  if (!buckets) {
+    return false;
+  }
+  memset(buckets, 0, bucket_count * sizeof(HakoRegisteredModule*));
+  for (uint32_t i = 0; i < registry->bucket_count; i++) {
+    HakoRegisteredModule* module = registry->buckets[i];
+    while (module) {
+      HakoRegisteredModule* next = module->next;
+      HakoRegisteredModule** bucket =
+          &buckets[module->hash & (bucket_count - 1)];
+      module->next = *bucket;
+      *bucket = module;
+      module = next;
+    }
+  }
+  lepus_free_rt(rt, registry->buckets);
+  registry->buckets = buckets;
+  registry->bucket_count = bucket_count;
+  return true;
+}
+
+static void hako_registry_free(LEPUSRuntime* rt,
+                               HakoModuleRegistry* registry) {
+  for (uint32_t i = 0; i < registry->bucket_count; i++) {
+    while (registry->buckets[i]) {
+      HakoRegisteredModule* module = registry->buckets[i];
+      registry->buckets[i] = module->next;
+      hako_registered_module_free(rt, module);
+    }
+  }
+  lepus_free_rt(rt, registry->buckets);
+  memset(registry, 0, sizeof(*registry));
+}
+
+// Copies the module into the registry, replacing any module of that name
+static bool hako_registry_add(LEPUSRuntime* rt, CString* name,
+                              const uint8_t* bytes, size_t length,
+                              bool is_bytecode) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (!data) {
+    return false;
+  }
+  HakoModuleRegistry* registry = &data->registry;
+  if (registry->count >= registry->bucket_count &&
+      !hako_registry_grow(rt, registry)) {
+    return false;
+  }
+
+  HakoRegisteredModule* module = lepus_malloc_rt(
+      rt, sizeof(HakoRegisteredModule), ALLOC_TAG_WITHOUT_PTR);
+  if (!module) {
+    return false;
+  }
+  memset(module, 0, sizeof(*module));
+  module->hash = hako_module_name_hash(name);
+  module->name = hako_strdup_rt(rt, name);
+  // Source is null-terminated for the compiler
+  module->data = lepus_malloc_rt(rt, length + (is_bytecode ? 0 : 1),
+                                 ALLOC_TAG_WITHOUT_PTR);
+  if (!module->name || (!module->data && length + !is_bytecode > 0)) {
+    hako_registered_module_free(rt, module);
+    return false;
+  }
+  if (length) {
+    memcpy(module->data, bytes, length);
+  }
+  if (!is_bytecode) {
+    module->data[length] = '\0';
+  }
+  module->length = length;
+  module->is_bytecode = is_bytecode;
+
+  HakoRegisteredModule** slot =
+      hako_registry_slot(registry, name, module->hash);
+  if (*slot) {
+    HakoRegisteredModule* old = *slot;
+    module->next = old->next;
+    hako_registered_module_free(rt, old);
+  } else {
+    module->next = NULL;
+    registry->count++;
+  }
+  *slot = module;
+  hako_module_cache_invalidate(rt, name);
+  return true;
+}
+
+// Import prefetch
+//
+// With prefetch enabled, the bridge scans module source for static import
+// specifiers and asks the host for all of them in one host_load_modules
+// call, then repeats for the sources that come back, so a whole import graph
+// is fetched level by level. The engine still resolves imports one at a
+// time, but normalization and loading are answered from the prefetched
+// entries without crossing to the host.
+
+#define HAKO_PREFETCH_MAX_LEVELS 64
+#define HAKO_PREFETCH_MAX_BATCH 1024
+
+static HakoContextState* hako_context_state(LEPUSContext* ctx, bool create);
+
+typedef void HakoImportFn(void* opaque, const char* specifier, size_t len);
+
+static inline bool hako_is_ident_char(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_' || c == '$' ||
+         (unsigned char)c >= 0x80;
+}
+
+static inline bool hako_ident_is(const char* p, size_t len,
+                                 const char* word) {
+  return strlen(word) == len && memcmp(p, word, len) == 0;
+}
+
+// Keywords after which a slash starts a regular expression
+static bool hako_ident_allows_regex(const char* p, size_t len) {
+  static const char* const keywords[] = {
+      "return", "typeof", "instanceof", "in",    "of",   "new",  "delete",
+      "void",   "throw",  "case",       "do",    "else", "yield", "await"};
+  for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++) {
+    if (hako_ident_is(p, len, keywords[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static const char* hako_skip_space(const char* p, const char* end) {
+  while (p < end) {
+    if (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r' || *p == '\f' ||
+        *p == '\v') {
+      p++;
+    } else if (p + 1 < end && p[0] == '/' && p[1] == '/') {
+      while (p < end && *p != '\n') {
+        p++;
+      }
+    } else if (p + 1 < end && p[0] == '/' && p[1] == '*') {
+      p += 2;
+      while (p + 1 < end && !(p[0] == '*' && p[1] == '/')) {
+        p++;
+      }
+      p = p + 1 < end ? p + 2 : end;
+    } else {
+      break;
+    }
+  }
+  return p;
+}
+
+// Skips a string or template literal; returns the position after it
+static const char* hako_skip_quoted(const char* p, const char* end) {
+  char quote = *p++;
+  while (p < end && *p != quote) {
+    if (*p == '\\') {
+      p++;
+    } else if (quote != '`' && *p == '\n') {
+      return p;
+    }
+    p++;
+  }
+  return p < end ? p + 1 : end;
+}
+
+static const char* hako_skip_regex(const char* p, const char* end) {
+  bool in_class = false;
+  for (p++; p < end && *p != '\n'; p++) {
+    if (*p == '\\') {
+      p++;
+    } else if (*p == '[') {
+      in_class = true;
+    } else if (*p == ']') {
+      in_class = false;
+    } else if (*p == '/' && !in_class) {
+      return p + 1;
+    }
+  }
+  return p < end ? p : end;
+}
+
+// Reports the specifiers of static import and export-from declarations.
+// This is a lexical approximation: unusual code may hide or invent a
+// specifier, which only affects how much is prefetched.
+static void hako_scan_imports(const char* source, size_t len, HakoImportFn* fn,
+                              void* opaque) {
+  const char* p = source;
+  const char* end = source + len;
+  bool in_decl = false;      // Inside an import or export declaration
+  bool want_source = false;  // The next string is a module specifier
+  bool regex_ok = true;      // A slash here starts a regular expression
+  bool after_dot = false;    // The next identifier is a property name
+
+  while ((p = hako_skip_space(p, end)) < end) {
+    char c = *p;
+    if (hako_is_ident_char(c)) {
+      const char* word = p;
+      while (p < end && hako_is_ident_char(*p)) {
+        p++;
+      }
+      size_t word_len = p - word;
+      if (after_dot) {
+        want_source = false;
+      } else if (hako_ident_is(word, word_len, "import")) {
+        // Skip import() and import.meta
+        const char* next = hako_skip_space(p, end);
+        in_decl = next < end && *next != '(' && *next != '.';
+        want_source = in_decl;
+      } else if (hako_ident_is(word, word_len, "export")) {
+        in_decl = true;
+        want_source = false;
+      } else {
+        want_source = in_decl && hako_ident_is(word, word_len, "from");
+      }
+      regex_ok = !after_dot && hako_ident_allows_regex(word, word_len);
+      after_dot = false;
+      continue;
+    }
+
+    if (c == '"' || c == '\'' || c == '`') {
+      const char* start = p + 1;
+      p = hako_skip_quoted(p, end);
+      const char* close = p - 1;
+      if (want_source && c != '`' && close >= start && *close == c &&
+          memchr(start, '\\', close - start) == NULL) {
+        // Import attributes such as { type: "json" } change how a module is
+        // loaded, so those imports are left to the regular path
+        const char* next = hako_skip_space(p, end);
+        size_t rest = end - next;
+        bool has_attributes =
+            (rest >= 4 && memcmp(next, "with", 4) == 0) ||
+            (rest >= 6 && memcmp(next, "assert", 6) == 0);
+        if (!has_attributes) {
+          fn(opaque, start, close - start);
+        }
+      }
+      if (want_source) {
+        in_decl = false;
+      }
+      want_source = false;
+      regex_ok = false;
+      after_dot = false;
+      continue;
+    }
+
+    if (c == '/' && regex_ok) {
+      p = hako_skip_regex(p, end);
+      want_source = false;
+      regex_ok = false;
+      continue;
+    }
+
+    p++;
+    if (c == ';') {
+      in_decl = false;
+    }
+    want_source = false;
+    after_dot = c == '.';
+    regex_ok = c != ')' && c != ']' && c != '}';
+  }
+}
+
+typedef struct HakoPrefetchLevel {
+  LEPUSRuntime* rt;
+  HakoContextState* state;
+  CString* base;  // Base name of the specifiers being collected
+  CString** bases;
+  char** specifiers;
+  uint32_t count;
+  uint32_t capacity;
+} HakoPrefetchLevel;
+
+static HakoPrefetchedModule* hako_prefetch_find_import(HakoContextState* state,
+                                                       CString* base,
+                                                       CString* specifier) {
+  for (HakoPrefetchedModule* entry = state->prefetched; entry;
+       entry = entry->next) {
+    if (strcmp(entry->specifier, specifier) == 0 &&
+        strcmp(entry->base, base) == 0) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+static HakoPrefetchedModule* hako_prefetch_find_name(HakoContextState* state,
+                                                     CString* name) {
+  for (HakoPrefetchedModule* entry = state->prefetched; entry;
+       entry = entry->next) {
+    if (strcmp(entry->name, name) == 0) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+// Resolves a specifier the way the engine's default normalizer does: bare
+// specifiers are names already, relative ones are joined to the directory
+// of base with "." and ".." segments removed
+static char* hako_prefetch_module_name(LEPUSRuntime* rt, CString* base,
+                                       CString* specifier) {
+  if (specifier[0] != '.') {
+    return hako_strdup_rt(rt, specifier);
+  }
+  const char* slash = strrchr(base, '/');
+  size_t dir_len = slash ? slash - base : 0;
+  size_t spec_len = strlen(specifier);
+  char* name =
+      lepus_malloc_rt(rt, dir_len + spec_len + 2, ALLOC_TAG_WITHOUT_PTR);
+  if (!name) {
+    return NULL;
+  }
+  memcpy(name, base, dir_len);
+  name[dir_len] = '\0';
+
+  const char* r = specifier;
+  for (;;) {
+    if (r[0] == '.' && r[1] == '/') {
+      r += 2;
+    } else if (r[0] == '.' && r[1] == '.' && r[2] == '/') {
+      // Drop the last directory, as long as there is one
+      char* last = strrchr(name, '/');
+      char* dir = last ? last + 1 : name;
+      if (dir[0] == '\0' || strcmp(dir, ".") == 0 ||
+          strcmp(dir, "..") == 0) {
+        break;
+      }
+      *(last ? last : name) = '\0';
+      r += 3;
+    } else {
+      break;
+    }
+  }
+  size_t len = strlen(name);
+  if (len > 0) {
+    name[len++] = '/';
+  }
+  memcpy(name + len, r, strlen(r) + 1);
+  return name;
+}
+
+static bool hako_module_cache_has(LEPUSRuntime* rt, CString* module_name) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (!data) {
+    return false;
+  }
+  for (HakoModuleCacheEntry* entry = data->modules; entry;
+       entry = entry->next) {
+    if (strcmp(entry->name, module_name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Whether the bridge can load the module without the host sending its
+// source in a batch: registered and bundled modules are read directly, and
+// cached modules are compiled already
+static bool hako_prefetch_is_local(LEPUSRuntime* rt, CString* base,
+                                   CString* specifier) {
+  char* name = hako_prefetch_module_name(rt, base, specifier);
+  if (!name) {
+    return false;
+  }
+  const uint8_t* bytecode;
+  uint32_t bytecode_len;
+  bool local = hako_registry_find(rt, name) != NULL ||
+               hako_bundle_find(rt, name, &bytecode, &bytecode_len) ||
+               hako_module_cache_has(rt, name);
+  lepus_free_rt(rt, name);
+  return local;
+}
+
+static void hako_prefetch_collect(void* opaque, const char* specifier,
+                                  size_t len) {
+  HakoPrefetchLevel* level = opaque;
+  LEPUSRuntime* rt = level->rt;
+  if (level->count >= HAKO_PREFETCH_MAX_BATCH) {
+    return;
+  }
+  char* copy = lepus_malloc_rt(rt, len + 1, ALLOC_TAG_WITHOUT_PTR);
+  if (!copy) {
+    return;
+  }
+  memcpy(copy, specifier, len);
+  copy[len] = '\0';
+
+  // Leave modules the bridge already has to the regular loader
+  if (hako_prefetch_is_local(rt, level->base, copy)) {
+    lepus_free_rt(rt, copy);
+    return;
+  }
+
+  bool seen =
+      hako_prefetch_find_import(level->state, level->base, copy) != NULL;
+  for (uint32_t i = 0; !seen && i < level->count; i++) {
+    seen = strcmp(level->specifiers[i], copy) == 0 &&
+           strcmp(level->bases[i], level->base) == 0;
+  }
+  if (seen) {
+    lepus_free_rt(rt, copy);
+    return;
+  }
+
+  if (level->count == level->capacity) {
+    uint32_t capacity = level->capacity ? level->capacity * 2 : 16;
+    CString** bases = lepus_malloc_rt(rt, capacity * sizeof(CString*),
+                                      ALLOC_TAG_WITHOUT_PTR);
+    char** specifiers =
+        lepus_malloc_rt(rt, capacity * sizeof(char*), ALLOC_TAG_WITHOUT_PTR);
+    if (!bases || !specifiers) {
+      lepus_free_rt(rt, bases);
+      lepus_free_rt(rt, specifiers);
+      lepus_free_rt(rt, copy);
+      return;
+    }
+    if (level->count) {
+      memcpy(bases, level->bases, level->count * sizeof(CString*));
+      memcpy(specifiers, level->specifiers, level->count * sizeof(char*));
+    }
+    lepus_free_rt(rt, level->bases);
+    lepus_free_rt(rt, level->specifiers);
+    level->bases = bases;
+    level->specifiers = specifiers;
+    level->capacity = capacity;
+  }
+  level->bases[level->count] = level->base;
+  level->specifiers[level->count] = copy;
+  level->count++;
+}
+
+static void hako_prefetch_level_free(HakoPrefetchLevel* level) {
+  for (uint32_t i = 0; i < level->count; i++) {
+    lepus_free_rt(level->rt, level->specifiers[i]);
+  }
+  lepus_free_rt(level->rt, level->bases);
+  lepus_free_rt(level->rt, level->specifiers);
+}
+
+static void hako_prefetch_entry_free(LEPUSRuntime* rt,
+                                     HakoPrefetchedModule* entry) {
+  lepus_free_rt(rt, entry->base);
+  lepus_free_rt(rt, entry->specifier);
+  lepus_free_rt(rt, entry->name);
+  lepus_free_rt(rt, entry->source);
+  lepus_free_rt(rt, entry->version);
+  lepus_free_rt(rt, entry);
+}
+
+static void hako_prefetch_free(LEPUSRuntime* rt, HakoContextState* state) {
+  while (state->prefetched) {
+    HakoPrefetchedModule* entry = state->prefetched;
+    state->prefetched = entry->next;
+    hako_prefetch_entry_free(rt, entry);
+  }
+}
+
+// Fetches one level of the import graph and collects the next one
+static void hako_prefetch_round(LEPUSContext* ctx, HakoPrefetchLevel* level,
+                                HakoPrefetchLevel* next) {
+  LEPUSRuntime* rt = level->rt;
+  HakoContextState* state = level->state;
+  size_t results_size = level->count * sizeof(HakoModulePrefetch);
+  HakoModulePrefetch* results =
+      lepus_malloc_rt(rt, results_size, ALLOC_TAG_WITHOUT_PTR);
+  if (!results) {
+    return;
+  }
+  memset(results, 0, results_size);
+  host_load_modules(rt, ctx, level->count, level->bases,
+                    (CString**)level->specifiers, results);
+
+  for (uint32_t i = 0; i < level->count; i++) {
+    HakoModulePrefetch* result = &results[i];
+    HakoPrefetchedModule* entry = NULL;
+    if (result->name && result->source) {
+      entry = lepus_malloc_rt(rt, sizeof(HakoPrefetchedModule),
+                              ALLOC_TAG_WITHOUT_PTR);
+    }
+    char* base = entry ? hako_strdup_rt(rt, level->bases[i]) : NULL;
+    if (!base) {
+      lepus_free_rt(rt, entry);
+      lepus_free_rt(rt, result->name);
+      lepus_free_rt(rt, result->source);
+      lepus_free_rt(rt, result->version);
+      continue;
+    }
+
+    // A module imported from several places is fetched once
+    bool repeated = hako_prefetch_find_name(state, result->name) != NULL;
+    entry->base = base;
+    entry->specifier = level->specifiers[i];
+    level->specifiers[i] = NULL;
+    entry->name = result->name;
+    entry->source = repeated ? NULL : result->source;
+    entry->version = repeated ? NULL : result->version;
+    entry->next = state->prefetched;
+    state->prefetched = entry;
+    if (repeated) {
+      lepus_free_rt(rt, result->source);
+      lepus_free_rt(rt, result->version);
+    } else {
+      next->base = entry->name;
+      hako_scan_imports(entry->source, strlen(entry->source),
+                        hako_prefetch_collect, next);
+    }
+  }
+  lepus_free_rt(rt, results);
+}
+
+static void hako_prefetch_imports(LEPUSContext* ctx, CString* base_name,
+                                  const char* source, size_t source_len) {
+  LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (!data || !data->prefetch_modules) {
+    return;
+  }
+  HakoContextState* state = hako_context_state(ctx, true);
+  if (!state) {
+    return;
+  }
+
+  HakoPrefetchLevel level = {.rt = rt, .state = state, .base = base_name};
+  hako_scan_imports(source, source_len, hako_prefetch_collect, &level);
+  for (uint32_t depth = 0;
+       level.count > 0 && depth < HAKO_PREFETCH_MAX_LEVELS; depth++) {
+    HakoPrefetchLevel next = {.rt = rt, .state = state};
+    hako_prefetch_round(ctx, &level, &next);
+    hako_prefetch_level_free(&level);
+    level = next;
+  }
+  hako_prefetch_level_free(&level);
+}
+
+// Hands over the prefetched source of module_name, if there is one
+static bool hako_prefetch_take(LEPUSContext* ctx, CString* module_name,
+                               char** out_source, char** out_version) {
+  HakoContextState* state = hako_context_state(ctx, false);
+  if (!state) {
+    return false;
+  }
+  for (HakoPrefetchedModule* entry = state->prefetched; entry;
+       entry = entry->next) {
+    if (entry->source && strcmp(entry->name, module_name) == 0) {
+      *out_source = entry->source;
+      *out_version = entry->version;
+      entry->source = NULL;
+      entry->version = NULL;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Compiles module source, or instantiates it from the runtime module cache.
+// Takes ownership of source_code.
+static LEPUSModuleDef* hako_load_module_source(LEPUSContext* ctx,
+                                               CString* module_name,
+                                               char* source_code,
+                                               CString* version) {
+  LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+  if (source_code == NULL) {
+    LEPUS_ThrowTypeError(ctx, "Invalid source code for module '%s'",
+                         module_name);
+    return NULL;
+  }
+  hako_prefetch_imports(ctx, module_name, source_code, strlen(source_code));
+
+  // Skip compilation if another context already compiled this version
+  LEPUSModuleDef* result;
+  HakoModuleCacheEntry* cached =
+      version ? hako_module_cache_find(rt, module_name, version) : NULL;
+  if (cached) {
+    result = hako_read_module(ctx, module_name, cached->bytecode,
+                              cached->bytecode_len);
+  } else {
+    result = hako_compile_module(ctx, module_name, source_code, version);
+  }
+  lepus_free(ctx, source_code);
+  return result;
+}
+
 static LEPUSModuleDef* hako_load_module(LEPUSContext* ctx, CString* module_name,
                                         void* user_data,
                                         LEPUSValueConst attributes) {
   LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+
+  HakoRegisteredModule* registered = hako_registry_find(rt, module_name);
+  if (registered) {
+    if (registered->is_bytecode) {
+      return hako_read_module(ctx, module_name, registered->data,
+                              registered->length);
+    }
+    char* source = lepus_malloc(ctx, registered->length + 1,
+                                ALLOC_TAG_WITHOUT_PTR);
+    if (!source) {
+      LEPUS_ThrowOutOfMemory(ctx);
+      return NULL;
+    }
+    memcpy(source, registered->data, registered->length + 1);
+    return hako_load_module_source(ctx, module_name, source,
+                                   HAKO_REGISTERED_MODULE_VERSION);
+  }
+
+  // Loaded bundles satisfy imports without a round trip to the host
+  const uint8_t* bytecode;
+  uint32_t bytecode_len;
+  if (hako_bundle_find(rt, module_name, &bytecode, &bytecode_len)) {
+    return hako_read_module(ctx, module_name, bytecode, bytecode_len);
+  }
+
+  char* prefetched_source;
+  char* prefetched_version;
+  if (hako_prefetch_take(ctx, module_name, &prefetched_source,
+                         &prefetched_version)) {
+    LEPUSModuleDef* result = hako_load_module_source(
+        ctx, module_name, prefetched_source, prefetched_version);
+    lepus_free(ctx, prefetched_version);
+    return result;
+  }
+
   HakoModuleSource* module_source =
       host_load_module(rt, ctx, module_name, user_data, &attributes);
 
@@ -259,16 +1346,9 @@ static LEPUSModuleDef* hako_load_module(LEPUSContext* ctx, CString* module_name,
 
   switch (module_source->type) {
     case HAKO_MODULE_SOURCE_STRING: {
-      // Compile source code to module
-      char* source_code = (char*)module_source->data.source_code;
-      if (source_code != NULL) {
-        result = hako_compile_module(ctx, module_name, source_code);
-        // Free the source code
-        lepus_free(ctx, source_code);
-      } else {
-        LEPUS_ThrowTypeError(ctx, "Invalid source code for module '%s'",
-                             module_name);
-      }
+      result = hako_load_module_source(ctx, module_name,
+                                       module_source->data.source_code,
+                                       module_source->version);
       break;
     }
 
@@ -294,6 +1374,7 @@ static LEPUSModuleDef* hako_load_module(LEPUSContext* ctx, CString* module_name,
   }
 
   // Free the HakoModuleSource struct
+  lepus_free(ctx, module_source->version);
   lepus_free(ctx, module_source);
 
   return result;
@@ -302,6 +1383,14 @@ static LEPUSModuleDef* hako_load_module(LEPUSContext* ctx, CString* module_name,
 static char* hako_normalize_module(LEPUSContext* ctx, CString* module_base_name,
                                    CString* module_name, void* user_data) {
   LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+  HakoContextState* state = hako_context_state(ctx, false);
+  HakoPrefetchedModule* prefetched =
+      state ? hako_prefetch_find_import(state, module_base_name, module_name)
+            : NULL;
+  if (prefetched) {
+    return lepus_strdup(ctx, prefetched->name, 1);
+  }
+
   char* normalized_module_name =
       host_normalize_module(rt, ctx, module_base_name, module_name, user_data);
   char* js_module_name = lepus_strdup(ctx, normalized_module_name, 1);
@@ -318,28 +1407,363 @@ static char* hako_resolve_module(LEPUSContext* ctx, CString* module_name,
   if (resolved_module_name == NULL) {
     return NULL;
   }
-
-  char* js_resolved_module_name = lepus_strdup(ctx, resolved_module_name, 1);
-  lepus_free(ctx, resolved_module_name);
-  return js_resolved_module_name;
+
+  char* js_resolved_module_name = lepus_strdup(ctx, resolved_module_name, 1);
+  lepus_free(ctx, resolved_module_name);
+  return js_resolved_module_name;
+}
+
+/**
+ * Constant pointers. Because we always use LEPUSValue* from the host Javascript
+ * environment, we need helper functions to return pointers to these constants.
+ */
+
+LEPUSValueConst HAKO_Undefined = LEPUS_UNDEFINED;
+LEPUSValueConst* WASM_EXPORT(HAKO_GetUndefined)() { return &HAKO_Undefined; }
+
+LEPUSValueConst HAKO_Null = LEPUS_NULL;
+LEPUSValueConst* WASM_EXPORT(HAKO_GetNull)() { return &HAKO_Null; }
+
+LEPUSValueConst HAKO_False = LEPUS_FALSE;
+LEPUSValueConst* WASM_EXPORT(HAKO_GetFalse)() { return &HAKO_False; }
+
+LEPUSValueConst HAKO_True = LEPUS_TRUE;
+LEPUSValueConst* WASM_EXPORT(HAKO_GetTrue)() { return &HAKO_True; }
+
+// Handle table
+
+static HakoHandleTable* hako_handle_table(LEPUSRuntime* rt) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  return data ? &data->handles : NULL;
+}
+
+static inline HakoHandleSlot* hako_handle_slot_at(HakoHandleTable* table,
+                                                  uint32_t index) {
+  return &table->pages[index >> HAKO_HANDLE_PAGE_BITS]
+                      [index & (HAKO_HANDLE_PAGE_SIZE - 1)];
+}
+
+static inline uint32_t hako_handle_encode(HakoHandleSlot* slot) {
+  return ((slot->generation & HAKO_HANDLE_GENERATION_MASK)
+          << HAKO_HANDLE_INDEX_BITS) |
+         (slot->index + 1);
+}
+
+static bool hako_u32_reserve(LEPUSRuntime* rt, uint32_t** items,
+                             uint32_t* capacity, uint32_t needed) {
+  if (needed <= *capacity) {
+    return true;
+  }
+  uint32_t new_capacity = *capacity ? *capacity * 2 : 64;
+  while (new_capacity < needed) {
+    new_capacity *= 2;
+  }
+  uint32_t* grown = lepus_malloc_rt(rt, sizeof(uint32_t) * new_capacity,
+                                    ALLOC_TAG_WITHOUT_PTR);
+  if (!grown) {
+    return false;
+  }
+  if (*items) {
+    memcpy(grown, *items, sizeof(uint32_t) * (*capacity));
+    lepus_free_rt(rt, *items);
+  }
+  *items = grown;
+  *capacity = new_capacity;
+  return true;
+}
+
+// Growable byte buffer for exports that return packed binary output
+typedef struct HakoByteBuffer {
+  LEPUSRuntime* rt;
+  uint8_t* data;
+  uint32_t len;
+  uint32_t capacity;
+  uint32_t limit;
+  bool over_limit;
+  bool out_of_memory;
+} HakoByteBuffer;
+
+static bool hako_buffer_reserve(HakoByteBuffer* buf, uint32_t extra) {
+  if (extra > buf->limit - buf->len) {
+    buf->over_limit = true;
+    return false;
+  }
+  uint32_t needed = buf->len + extra;
+  if (needed <= buf->capacity) {
+    return true;
+  }
+  uint32_t capacity = buf->capacity ? buf->capacity : 256;
+  while (capacity < needed) {
+    capacity = capacity > UINT32_MAX / 2 ? needed : capacity * 2;
+  }
+  uint8_t* grown = lepus_malloc_rt(buf->rt, capacity, ALLOC_TAG_WITHOUT_PTR);
+  if (!grown) {
+    buf->out_of_memory = true;
+    return false;
+  }
+  if (buf->data) {
+    memcpy(grown, buf->data, buf->len);
+    lepus_free_rt(buf->rt, buf->data);
+  }
+  buf->data = grown;
+  buf->capacity = capacity;
+  return true;
+}
+
+static bool hako_buffer_write(HakoByteBuffer* buf, const void* src,
+                              uint32_t size) {
+  if (!hako_buffer_reserve(buf, size)) {
+    return false;
+  }
+  memcpy(buf->data + buf->len, src, size);
+  buf->len += size;
+  return true;
+}
+
+static inline bool hako_buffer_u8(HakoByteBuffer* buf, uint8_t value) {
+  return hako_buffer_write(buf, &value, sizeof(value));
+}
+
+static inline bool hako_buffer_u32(HakoByteBuffer* buf, uint32_t value) {
+  return hako_buffer_write(buf, &value, sizeof(value));
+}
+
+static inline bool hako_buffer_f64(HakoByteBuffer* buf, double value) {
+  return hako_buffer_write(buf, &value, sizeof(value));
+}
+
+static void hako_handle_release(HakoHandleTable* table, HakoHandleSlot* slot);
+
+// ctx is the context the value is boxed for, or NULL for runtime-level
+// values, which are never scoped
+static HakoHandleSlot* hako_handle_alloc(LEPUSRuntime* rt,
+                                         HakoHandleTable* table,
+                                         LEPUSContext* ctx) {
+  HakoHandleSlot* slot;
+  if (table->free_head != HAKO_HANDLE_SLOT_NONE) {
+    slot = hako_handle_slot_at(table, table->free_head);
+    table->free_head = slot->next_free;
+  } else {
+    if (table->slot_count >= HAKO_HANDLE_MAX_SLOTS) {
+      return NULL;
+    }
+    if (table->slot_count == table->page_count * HAKO_HANDLE_PAGE_SIZE) {
+      HakoHandleSlot* page =
+          lepus_malloc_rt(rt, sizeof(HakoHandleSlot) * HAKO_HANDLE_PAGE_SIZE,
+                          ALLOC_TAG_WITHOUT_PTR);
+      if (!page) {
+        return NULL;
+      }
+      table->pages[table->page_count++] = page;
+    }
+    slot = hako_handle_slot_at(table, table->slot_count);
+    slot->index = table->slot_count++;
+    slot->generation = 0;
+  }
+  slot->next_free = HAKO_HANDLE_SLOT_LIVE;
+  slot->scope = 0;
+  slot->scope_ctx = NULL;
+  table->live_count++;
+
+  // The context lookup is skipped unless some context has a scope open
+  if (ctx && table->open_scopes > 0) {
+    HakoContextState* state = hako_context_state(ctx, false);
+    if (state && state->scope_depth > 0) {
+      if (!hako_u32_reserve(rt, &state->scope_log,
+                            &state->scope_log_capacity,
+                            state->scope_log_len + 1)) {
+        hako_handle_release(table, slot);
+        return NULL;
+      }
+      state->scope_log[state->scope_log_len++] = hako_handle_encode(slot);
+      slot->scope = state->scope_depth;
+      slot->scope_ctx = ctx;
+    }
+  }
+  return slot;
+}
+
+/**
+ * Maps a value pointer back to its live slot. Returns NULL for pointers that
+ * are not table slots (e.g. the HAKO_Get* constants) and for slots that have
+ * already been released.
+ */
+static HakoHandleSlot* hako_handle_from_value(HakoHandleTable* table,
+                                              LEPUSValueConst* value) {
+  if (value == NULL || value == &HAKO_Undefined || value == &HAKO_Null ||
+      value == &HAKO_False || value == &HAKO_True) {
+    return NULL;
+  }
+  HakoHandleSlot* slot = (HakoHandleSlot*)value;
+  if (slot->index >= table->slot_count ||
+      hako_handle_slot_at(table, slot->index) != slot ||
+      slot->next_free != HAKO_HANDLE_SLOT_LIVE) {
+    return NULL;
+  }
+  return slot;
+}
+
+static HakoHandleSlot* hako_handle_lookup(HakoHandleTable* table,
+                                          uint32_t handle) {
+  uint32_t index = (handle & HAKO_HANDLE_INDEX_MASK) - 1;
+  if (handle == 0 || index >= table->slot_count) {
+    return NULL;
+  }
+  HakoHandleSlot* slot = hako_handle_slot_at(table, index);
+  if (slot->next_free != HAKO_HANDLE_SLOT_LIVE ||
+      hako_handle_encode(slot) != handle) {
+    return NULL;
+  }
+  return slot;
+}
+
+static void hako_handle_release(HakoHandleTable* table, HakoHandleSlot* slot) {
+  slot->value = LEPUS_UNDEFINED;
+  slot->generation++;
+  slot->next_free = table->free_head;
+  table->free_head = slot->index;
+  table->live_count--;
+}
+
+static void hako_handle_table_free(LEPUSRuntime* rt, HakoHandleTable* table) {
+  for (uint32_t i = 0; i < table->page_count; i++) {
+    lepus_free_rt(rt, table->pages[i]);
+  }
+  memset(table, 0, sizeof(*table));
+  table->free_head = HAKO_HANDLE_SLOT_NONE;
+}
+
+static LEPUSValue* jsvalue_to_heap_rt(LEPUSRuntime* rt, LEPUSValueConst value) {
+  HakoHandleTable* table = hako_handle_table(rt);
+  if (table) {
+    HakoHandleSlot* slot = hako_handle_alloc(rt, table, NULL);
+    if (!slot) {
+      return NULL;
+    }
+    slot->value = value;
+    return &slot->value;
+  }
+
+  LEPUSValue* result =
+      lepus_malloc_rt(rt, sizeof(LEPUSValue), ALLOC_TAG_WITHOUT_PTR);
+  if (result) {
+    *result = value;
+  }
+  return result;
+}
+
+static LEPUSValue* jsvalue_to_heap(LEPUSContext* ctx, LEPUSValueConst value) {
+  LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+  HakoHandleTable* table = hako_handle_table(rt);
+  if (table) {
+    HakoHandleSlot* slot = hako_handle_alloc(rt, table, ctx);
+    if (!slot) {
+      LEPUS_ThrowOutOfMemory(ctx);
+      return NULL;
+    }
+    slot->value = value;
+    return &slot->value;
+  }
+
+  LEPUSValue* result =
+      lepus_malloc(ctx, sizeof(LEPUSValue), ALLOC_TAG_WITHOUT_PTR);
+  if (result) {
+    *result = value;
+  }
+  return result;
+}
+
+/**
+ * Releases the storage behind a pointer produced by jsvalue_to_heap without
+ * touching the value it holds. Returns false if the pointer is not a live
+ * box, in which case the caller must not free the value either.
+ */
+static bool jsvalue_heap_release(LEPUSRuntime* rt, LEPUSValue* value) {
+  HakoHandleTable* table = hako_handle_table(rt);
+  if (table) {
+    HakoHandleSlot* slot = hako_handle_from_value(table, value);
+    if (!slot) {
+      return false;
+    }
+    hako_handle_release(table, slot);
+    return true;
+  }
+
+  if (value == NULL || value == &HAKO_Undefined || value == &HAKO_Null ||
+      value == &HAKO_False || value == &HAKO_True) {
+    return false;
+  }
+  lepus_free_rt(rt, value);
+  return true;
+}
+
+// Context state
+
+static HakoContextState* hako_context_state(LEPUSContext* ctx, bool create) {
+  LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (!data) {
+    return NULL;
+  }
+  for (HakoContextState* state = data->contexts; state; state = state->next) {
+    if (state->ctx == ctx) {
+      return state;
+    }
+  }
+  if (!create) {
+    return NULL;
+  }
+  HakoContextState* state =
+      lepus_malloc_rt(rt, sizeof(HakoContextState), ALLOC_TAG_WITHOUT_PTR);
+  if (!state) {
+    return NULL;
+  }
+  memset(state, 0, sizeof(*state));
+  state->ctx = ctx;
+  state->next = data->contexts;
+  data->contexts = state;
+  return state;
 }
 
-static LEPUSValue* jsvalue_to_heap_rt(LEPUSRuntime* rt, LEPUSValueConst value) {
-  LEPUSValue* result =
-      lepus_malloc_rt(rt, sizeof(LEPUSValue), ALLOC_TAG_WITHOUT_PTR);
-  if (result) {
-    *result = value;
+static void hako_baseline_free(LEPUSRuntime* rt, HakoContextState* state) {
+  for (uint32_t i = 0; i < state->baseline_count; i++) {
+    HakoBaselineProperty* prop = &state->baseline[i];
+    LEPUS_FreeAtomRT(rt, prop->atom);
+    LEPUS_FreeValueRT(rt, prop->desc.value);
+    LEPUS_FreeValueRT(rt, prop->desc.getter);
+    LEPUS_FreeValueRT(rt, prop->desc.setter);
   }
-  return result;
+  lepus_free_rt(rt, state->baseline);
+  state->baseline = NULL;
+  state->baseline_count = 0;
 }
 
-static LEPUSValue* jsvalue_to_heap(LEPUSContext* ctx, LEPUSValueConst value) {
-  LEPUSValue* result =
-      lepus_malloc(ctx, sizeof(LEPUSValue), ALLOC_TAG_WITHOUT_PTR);
-  if (result) {
-    *result = value;
+static void hako_context_state_free(LEPUSRuntime* rt,
+                                    HakoContextState* state) {
+  hako_prefetch_free(rt, state);
+  hako_baseline_free(rt, state);
+  lepus_free_rt(rt, state->scratch_argv);
+  lepus_free_rt(rt, state->scope_log);
+  lepus_free_rt(rt, state->scope_marks);
+  lepus_free_rt(rt, state);
+}
+
+static void hako_context_state_remove(LEPUSContext* ctx) {
+  LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (!data) {
+    return;
+  }
+  for (HakoContextState** link = &data->contexts; *link;
+       link = &(*link)->next) {
+    if ((*link)->ctx == ctx) {
+      HakoContextState* state = *link;
+      *link = state->next;
+      data->handles.open_scopes -= state->scope_depth;
+      hako_context_state_free(rt, state);
+      return;
+    }
   }
-  return result;
 }
 
 LEPUSValue* WASM_EXPORT(HAKO_Throw)(LEPUSContext* ctx, LEPUSValueConst* error) {
@@ -482,22 +1906,202 @@ void WASM_EXPORT(HAKO_ContextSetMaxStackSize)(LEPUSContext* ctx,
   LEPUS_SetMaxStackSize(ctx, stack_size);
 }
 
-/**
- * Constant pointers. Because we always use LEPUSValue* from the host Javascript
- * environment, we need helper functions to return pointers to these constants.
- */
+// Script cache
+//
+// HAKO_Eval looks scripts up by a hash of (source, filename, flags) and
+// instantiates cached bytecode instead of detecting, parsing and compiling
+// again. A hit also requires the source bytes and the runtime strip flags to
+// match, so a hash collision or a strip setting change never serves bytecode
+// compiled from something else. Modules are not cached: they register themselves by name in the
+// context that loads them.
+
+#define HAKO_SCRIPT_HASH_SEED 0xcbf29ce484222325ULL
+
+// Completes a hash started with hako_hash_bytes(HAKO_SCRIPT_HASH_SEED, ...)
+// over the source, which lets buffered sources be hashed as chunks arrive
+static uint64_t hako_script_hash_finish(uint64_t source_hash,
+                                        const char* filename, int eval_flags,
+                                        LEPUS_BOOL detect_module) {
+  uint64_t hash =
+      hako_hash_bytes(source_hash, filename, strlen(filename) + 1);
+  hash = hako_hash_bytes(hash, &eval_flags, sizeof(eval_flags));
+  return hako_hash_bytes(hash, &detect_module, sizeof(detect_module));
+}
 
-LEPUSValueConst HAKO_Undefined = LEPUS_UNDEFINED;
-LEPUSValueConst* WASM_EXPORT(HAKO_GetUndefined)() { return &HAKO_Undefined; }
+static uint64_t hako_script_hash(const char* source, size_t source_len,
+                                 const char* filename, int eval_flags,
+                                 LEPUS_BOOL detect_module) {
+  return hako_script_hash_finish(
+      hako_hash_bytes(HAKO_SCRIPT_HASH_SEED, source, source_len), filename,
+      eval_flags, detect_module);
+}
 
-LEPUSValueConst HAKO_Null = LEPUS_NULL;
-LEPUSValueConst* WASM_EXPORT(HAKO_GetNull)() { return &HAKO_Null; }
+static HakoScriptCache* hako_script_cache(LEPUSContext* ctx) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(LEPUS_GetRuntime(ctx));
+  return data && data->scripts.stats.limit ? &data->scripts : NULL;
+}
 
-LEPUSValueConst HAKO_False = LEPUS_FALSE;
-LEPUSValueConst* WASM_EXPORT(HAKO_GetFalse)() { return &HAKO_False; }
+static void hako_script_cache_unlink(HakoScriptCache* cache,
+                                     HakoScriptCacheEntry* entry) {
+  if (entry->prev) {
+    entry->prev->next = entry->next;
+  } else {
+    cache->head = entry->next;
+  }
+  if (entry->next) {
+    entry->next->prev = entry->prev;
+  } else {
+    cache->tail = entry->prev;
+  }
+  entry->prev = entry->next = NULL;
+}
 
-LEPUSValueConst HAKO_True = LEPUS_TRUE;
-LEPUSValueConst* WASM_EXPORT(HAKO_GetTrue)() { return &HAKO_True; }
+static void hako_script_cache_push(HakoScriptCache* cache,
+                                   HakoScriptCacheEntry* entry) {
+  entry->next = cache->head;
+  if (cache->head) {
+    cache->head->prev = entry;
+  } else {
+    cache->tail = entry;
+  }
+  cache->head = entry;
+}
+
+static void hako_script_cache_remove(LEPUSRuntime* rt, HakoScriptCache* cache,
+                                     HakoScriptCacheEntry* entry) {
+  hako_script_cache_unlink(cache, entry);
+  cache->stats.entries--;
+  cache->stats.bytes -= entry->size;
+  lepus_free_rt(rt, entry->source);
+  lepus_free_rt(rt, entry->filename);
+  lepus_free_rt(rt, entry->bytecode);
+  lepus_free_rt(rt, entry);
+}
+
+// Evicts least recently used entries until the cache fits within limit
+static void hako_script_cache_trim(LEPUSRuntime* rt, HakoScriptCache* cache,
+                                   size_t limit) {
+  while (cache->tail && cache->stats.bytes > limit) {
+    hako_script_cache_remove(rt, cache, cache->tail);
+    cache->stats.evictions++;
+  }
+}
+
+static void hako_script_cache_purge(LEPUSRuntime* rt, HakoScriptCache* cache) {
+  while (cache->head) {
+    hako_script_cache_remove(rt, cache, cache->head);
+  }
+}
+
+static HakoScriptCacheEntry* hako_script_cache_find(
+    LEPUSContext* ctx, HakoScriptCache* cache, uint64_t hash,
+    const char* source, size_t source_len, const char* filename,
+    int eval_flags, LEPUS_BOOL detect_module) {
+  int strip_flags = LEPUS_GetStripInfo(LEPUS_GetRuntime(ctx));
+  for (HakoScriptCacheEntry* entry = cache->head; entry;
+       entry = entry->next) {
+    if (entry->hash == hash && entry->source_len == source_len &&
+        entry->eval_flags == eval_flags &&
+        entry->detect_module == detect_module &&
+        entry->strip_flags == strip_flags &&
+        strcmp(entry->filename, filename) == 0 &&
+        memcmp(entry->source, source, source_len) == 0) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+// Best effort: a script that cannot be cached is still evaluated normally
+static void hako_script_cache_store(LEPUSContext* ctx, HakoScriptCache* cache,
+                                    uint64_t hash, const char* source,
+                                    size_t source_len, const char* filename,
+                                    int eval_flags, LEPUS_BOOL detect_module,
+                                    LEPUSValueConst func) {
+  LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+  size_t bytecode_len;
+  uint8_t* bytecode =
+      LEPUS_WriteObject(ctx, &bytecode_len, func, LEPUS_WRITE_OBJ_BYTECODE);
+  if (!bytecode) {
+    LEPUS_FreeValue(ctx, LEPUS_GetException(ctx));
+    return;
+  }
+  size_t filename_len = strlen(filename) + 1;
+  size_t size = sizeof(HakoScriptCacheEntry) + source_len + filename_len +
+                bytecode_len;
+  if (size > cache->stats.limit) {
+    lepus_free_rt(rt, bytecode);
+    return;
+  }
+  HakoScriptCacheEntry* entry = lepus_malloc_rt(
+      rt, sizeof(HakoScriptCacheEntry), ALLOC_TAG_WITHOUT_PTR);
+  char* filename_copy =
+      entry ? lepus_malloc_rt(rt, filename_len, ALLOC_TAG_WITHOUT_PTR) : NULL;
+  // At least one byte, so that an empty source is not mistaken for a failure
+  char* source_copy =
+      filename_copy ? lepus_malloc_rt(rt, source_len ? source_len : 1,
+                                      ALLOC_TAG_WITHOUT_PTR)
+                    : NULL;
+  if (!source_copy) {
+    lepus_free_rt(rt, filename_copy);
+    lepus_free_rt(rt, entry);
+    lepus_free_rt(rt, bytecode);
+    return;
+  }
+  memset(entry, 0, sizeof(*entry));
+  memcpy(filename_copy, filename, filename_len);
+  memcpy(source_copy, source, source_len);
+  entry->hash = hash;
+  entry->source = source_copy;
+  entry->source_len = source_len;
+  entry->filename = filename_copy;
+  entry->eval_flags = eval_flags;
+  entry->detect_module = detect_module;
+  entry->strip_flags = LEPUS_GetStripInfo(rt);
+  entry->bytecode = bytecode;
+  entry->bytecode_len = bytecode_len;
+  entry->size = size;
+
+  hako_script_cache_trim(rt, cache, cache->stats.limit - size);
+  hako_script_cache_push(cache, entry);
+  cache->stats.entries++;
+  cache->stats.bytes += size;
+}
+
+// Compiles (or instantiates from the cache) and runs a non-module script
+static LEPUSValue hako_script_cache_eval(LEPUSContext* ctx,
+                                         HakoScriptCache* cache,
+                                         HakoScriptCacheEntry* entry,
+                                         uint64_t hash, const char* js_code,
+                                         size_t js_code_length,
+                                         const char* filename,
+                                         LEPUS_BOOL detect_module,
+                                         int eval_flags) {
+  LEPUSValue func;
+  if (entry) {
+    cache->stats.hits++;
+    hako_script_cache_unlink(cache, entry);
+    hako_script_cache_push(cache, entry);
+    func = LEPUS_ReadObject(ctx, entry->bytecode, entry->bytecode_len,
+                            LEPUS_READ_OBJ_BYTECODE);
+  } else {
+    cache->stats.misses++;
+    func = LEPUS_Eval(ctx, js_code, js_code_length, filename,
+                      eval_flags | LEPUS_EVAL_FLAG_COMPILE_ONLY);
+    if (!LEPUS_IsException(func)) {
+      hako_script_cache_store(ctx, cache, hash, js_code, js_code_length,
+                              filename, eval_flags, detect_module, func);
+    }
+  }
+  if (LEPUS_IsException(func) ||
+      (eval_flags & LEPUS_EVAL_FLAG_COMPILE_ONLY) != 0) {
+    return func;
+  }
+  LEPUSValue global = LEPUS_GetGlobalObject(ctx);
+  LEPUSValue result = LEPUS_EvalFunction(ctx, func, global);
+  LEPUS_FreeValue(ctx, global);
+  return result;
+}
 
 /**
  * Standard FFI functions
@@ -531,10 +2135,47 @@ LEPUSRuntime* WASM_EXPORT(HAKO_NewRuntime)() {
 #endif
 
 #endif
+
+  hako_RuntimeData* data =
+      lepus_malloc_rt(rt, sizeof(hako_RuntimeData), ALLOC_TAG_WITHOUT_PTR);
+  if (data == NULL) {
+    LEPUS_FreeRuntime(rt);
+    return NULL;
+  }
+  memset(data, 0, sizeof(*data));
+  data->handles.free_head = HAKO_HANDLE_SLOT_NONE;
+  data->scripts.stats.limit = HAKO_SCRIPT_CACHE_DEFAULT_LIMIT;
+  LEPUS_SetRuntimeOpaque(rt, data);
   return rt;
 }
 
-void WASM_EXPORT(HAKO_FreeRuntime)(LEPUSRuntime* rt) { LEPUS_FreeRuntime(rt); }
+// Captured in the data segments of a pre-initialized build
+static LEPUSRuntime* preinitialized_runtime = NULL;
+static LEPUSContext* preinitialized_context = NULL;
+
+void WASM_EXPORT(HAKO_FreeRuntime)(LEPUSRuntime* rt) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  // Freed captured state must not be handed out again
+  if (rt == preinitialized_runtime) {
+    preinitialized_runtime = NULL;
+    preinitialized_context = NULL;
+  }
+  if (data) {
+    hako_script_cache_purge(rt, &data->scripts);
+    hako_bundles_free(rt, data);
+    hako_module_cache_invalidate(rt, NULL);
+    hako_registry_free(rt, &data->registry);
+    hako_handle_table_free(rt, &data->handles);
+    while (data->contexts) {
+      HakoContextState* state = data->contexts;
+      data->contexts = state->next;
+      hako_context_state_free(rt, state);
+    }
+    LEPUS_SetRuntimeOpaque(rt, NULL);
+    lepus_free_rt(rt, data);
+  }
+  LEPUS_FreeRuntime(rt);
+}
 
 void WASM_EXPORT(HAKO_SetStripInfo)(LEPUSRuntime* rt, int flags) {
   LEPUS_SetStripInfo(rt, flags);
@@ -544,6 +2185,19 @@ int WASM_EXPORT(HAKO_GetStripInfo)(LEPUSRuntime* rt) {
   return LEPUS_GetStripInfo(rt);
 }
 
+void WASM_EXPORT(HAKO_SetPreinitialized)(LEPUSRuntime* rt, LEPUSContext* ctx) {
+  preinitialized_runtime = rt;
+  preinitialized_context = ctx;
+}
+
+LEPUSRuntime* WASM_EXPORT(HAKO_GetPreinitializedRuntime)() {
+  return preinitialized_runtime;
+}
+
+LEPUSContext* WASM_EXPORT(HAKO_GetPreinitializedContext)() {
+  return preinitialized_context;
+}
+
 LEPUSContext* WASM_EXPORT(HAKO_NewContext)(LEPUSRuntime* rt,
                                            HAKO_Intrinsic intrinsics) {
   if (intrinsics == 0) {
@@ -618,18 +2272,289 @@ void WASM_EXPORT(HAKO_SetVirtualStackSize)(LEPUSContext* ctx, uint32_t size) {
 }
 
 void WASM_EXPORT(HAKO_FreeContext)(LEPUSContext* ctx) {
+  if (ctx == preinitialized_context) {
+    preinitialized_context = NULL;
+  }
+  hako_context_state_remove(ctx);
   LEPUS_FreeContext(ctx);
 }
 
+// Context reset
+
+#define HAKO_BASELINE_GPN_FLAGS (LEPUS_GPN_STRING_MASK | LEPUS_GPN_SYMBOL_MASK)
+
+static HakoBaselineProperty* hako_baseline_find(HakoContextState* state,
+                                                LEPUSAtom atom,
+                                                uint32_t* hint) {
+  // Properties that survive keep their enumeration order, so a match is
+  // usually found at the hint
+  for (uint32_t n = 0; n < state->baseline_count; n++) {
+    uint32_t i = (*hint + n) % state->baseline_count;
+    if (state->baseline[i].atom == atom) {
+      *hint = i + 1;
+      return &state->baseline[i];
+    }
+  }
+  return NULL;
+}
+
+// Returns 1 if the property matches its baseline or was redefined to match,
+// 0 if it cannot be redefined (made non-configurable), -1 on exception
+static int hako_baseline_restore(LEPUSContext* ctx, LEPUSValueConst global,
+                                 const HakoBaselineProperty* prop) {
+  LEPUSPropertyDescriptor desc;
+  int found = LEPUS_GetOwnProperty(ctx, &desc, global, prop->atom);
+  if (found < 0) {
+    return -1;
+  }
+  if (found) {
+    bool same = desc.flags == prop->desc.flags &&
+                LEPUS_SameValue(ctx, desc.value, prop->desc.value) &&
+                LEPUS_SameValue(ctx, desc.getter, prop->desc.getter) &&
+                LEPUS_SameValue(ctx, desc.setter, prop->desc.setter);
+    LEPUS_FreeValue(ctx, desc.value);
+    LEPUS_FreeValue(ctx, desc.getter);
+    LEPUS_FreeValue(ctx, desc.setter);
+    if (same) {
+      return 1;
+    }
+  }
+
+  int flags = LEPUS_PROP_HAS_CONFIGURABLE | LEPUS_PROP_HAS_ENUMERABLE |
+              (prop->desc.flags &
+               (LEPUS_PROP_CONFIGURABLE | LEPUS_PROP_ENUMERABLE));
+  if (prop->desc.flags & LEPUS_PROP_GETSET) {
+    flags = flags | LEPUS_PROP_HAS_GET | LEPUS_PROP_HAS_SET;
+  } else {
+    flags = flags | LEPUS_PROP_HAS_VALUE | LEPUS_PROP_HAS_WRITABLE |
+            (prop->desc.flags & LEPUS_PROP_WRITABLE);
+  }
+  return LEPUS_DefineProperty(ctx, global, prop->atom, prop->desc.value,
+                              prop->desc.getter, prop->desc.setter, flags);
+}
+
+int WASM_EXPORT(HAKO_SaveContextBaseline)(LEPUSContext* ctx) {
+  LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+  HakoContextState* state = hako_context_state(ctx, true);
+  if (!state) {
+    LEPUS_ThrowOutOfMemory(ctx);
+    return -1;
+  }
+
+  LEPUSValue global = LEPUS_GetGlobalObject(ctx);
+  LEPUSPropertyEnum* tab = NULL;
+  uint32_t len = 0;
+  if (LEPUS_GetOwnPropertyNames(ctx, &tab, &len, global,
+                                HAKO_BASELINE_GPN_FLAGS) < 0) {
+    LEPUS_FreeValue(ctx, global);
+    return -1;
+  }
+
+  HakoBaselineProperty* baseline =
+      lepus_malloc_rt(rt, sizeof(HakoBaselineProperty) * (len ? len : 1),
+                      ALLOC_TAG_WITHOUT_PTR);
+  if (!baseline) {
+    LEPUS_FreePropertyEnum(ctx, tab, len);
+    LEPUS_FreeValue(ctx, global);
+    LEPUS_ThrowOutOfMemory(ctx);
+    return -1;
+  }
+
+  // Descriptors are read directly so that getters do not run
+  uint32_t count = 0;
+  int ret = 0;
+  for (uint32_t i = 0; i < len; i++) {
+    HakoBaselineProperty* prop = &baseline[count];
+    int found = LEPUS_GetOwnProperty(ctx, &prop->desc, global, tab[i].atom);
+    if (found < 0) {
+      ret = -1;
+      break;
+    }
+    if (found) {
+      prop->atom = LEPUS_DupAtom(ctx, tab[i].atom);
+      count++;
+    }
+  }
+  LEPUS_FreePropertyEnum(ctx, tab, len);
+  LEPUS_FreeValue(ctx, global);
+
+  hako_baseline_free(rt, state);
+  state->baseline = baseline;
+  state->baseline_count = count;
+  if (ret < 0) {
+    hako_baseline_free(rt, state);
+  }
+  return ret;
+}
+
+int WASM_EXPORT(HAKO_ResetContext)(LEPUSContext* ctx) {
+  HakoContextState* state = hako_context_state(ctx, false);
+  if (!state || !state->baseline) {
+    LEPUS_ThrowTypeError(ctx, "Context has no saved baseline");
+    return -1;
+  }
+
+  LEPUSValue global = LEPUS_GetGlobalObject(ctx);
+  LEPUSPropertyEnum* tab = NULL;
+  uint32_t len = 0;
+  if (LEPUS_GetOwnPropertyNames(ctx, &tab, &len, global,
+                                HAKO_BASELINE_GPN_FLAGS) < 0) {
+    LEPUS_FreeValue(ctx, global);
+    return -1;
+  }
+
+  int leftover = 0;
+  uint32_t hint = 0;
+  for (uint32_t i = 0; i < len && leftover >= 0; i++) {
+    if (hako_baseline_find(state, tab[i].atom, &hint)) {
+      continue;
+    }
+    int deleted = LEPUS_DeleteProperty(ctx, global, tab[i].atom, 0);
+    if (deleted < 0) {
+      leftover = -1;
+    } else if (!deleted) {
+      leftover++;
+    }
+  }
+  LEPUS_FreePropertyEnum(ctx, tab, len);
+
+  for (uint32_t i = 0; i < state->baseline_count && leftover >= 0; i++) {
+    int restored = hako_baseline_restore(ctx, global, &state->baseline[i]);
+    if (restored < 0) {
+      leftover = -1;
+    } else if (!restored) {
+      leftover++;
+    }
+  }
+  LEPUS_FreeValue(ctx, global);
+  return leftover;
+}
+
 void WASM_EXPORT(HAKO_FreeValuePointer)(LEPUSContext* ctx, LEPUSValue* value) {
-  LEPUS_FreeValue(ctx, *value);
-  lepus_free(ctx, value);
+  LEPUSValue copy = *value;
+  if (jsvalue_heap_release(LEPUS_GetRuntime(ctx), value)) {
+    LEPUS_FreeValue(ctx, copy);
+  }
 }
 
 void WASM_EXPORT(HAKO_FreeValuePointerRuntime)(LEPUSRuntime* rt,
                                                LEPUSValue* value) {
-  LEPUS_FreeValueRT(rt, *value);
-  lepus_free_rt(rt, value);
+  LEPUSValue copy = *value;
+  if (jsvalue_heap_release(rt, value)) {
+    LEPUS_FreeValueRT(rt, copy);
+  }
+}
+
+uint32_t WASM_EXPORT(HAKO_ValueToHandle)(LEPUSContext* ctx,
+                                         LEPUSValueConst* value) {
+  HakoHandleTable* table = hako_handle_table(LEPUS_GetRuntime(ctx));
+  if (!table) {
+    return 0;
+  }
+  HakoHandleSlot* slot = hako_handle_from_value(table, value);
+  return slot ? hako_handle_encode(slot) : 0;
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_HandleToValue)(LEPUSContext* ctx,
+                                            uint32_t handle) {
+  HakoHandleTable* table = hako_handle_table(LEPUS_GetRuntime(ctx));
+  if (!table) {
+    return NULL;
+  }
+  HakoHandleSlot* slot = hako_handle_lookup(table, handle);
+  return slot ? &slot->value : NULL;
+}
+
+LEPUS_BOOL WASM_EXPORT(HAKO_FreeHandle)(LEPUSContext* ctx, uint32_t handle) {
+  HakoHandleTable* table = hako_handle_table(LEPUS_GetRuntime(ctx));
+  if (!table) {
+    return 0;
+  }
+  HakoHandleSlot* slot = hako_handle_lookup(table, handle);
+  if (!slot) {
+    return 0;
+  }
+  LEPUSValue copy = slot->value;
+  hako_handle_release(table, slot);
+  LEPUS_FreeValue(ctx, copy);
+  return 1;
+}
+
+uint32_t WASM_EXPORT(HAKO_GetLiveHandleCount)(LEPUSRuntime* rt) {
+  HakoHandleTable* table = hako_handle_table(rt);
+  return table ? table->live_count : 0;
+}
+
+uint32_t WASM_EXPORT(HAKO_PushValueScope)(LEPUSContext* ctx) {
+  LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+  HakoHandleTable* table = hako_handle_table(rt);
+  if (!table) {
+    return 0;
+  }
+  HakoContextState* state = hako_context_state(ctx, true);
+  if (!state ||
+      !hako_u32_reserve(rt, &state->scope_marks, &state->scope_marks_capacity,
+                        state->scope_depth + 1)) {
+    LEPUS_ThrowOutOfMemory(ctx);
+    return 0;
+  }
+  state->scope_marks[state->scope_depth++] = state->scope_log_len;
+  table->open_scopes++;
+  return state->scope_depth;
+}
+
+int WASM_EXPORT(HAKO_PopValueScope)(LEPUSContext* ctx, uint32_t scope) {
+  HakoHandleTable* table = hako_handle_table(LEPUS_GetRuntime(ctx));
+  HakoContextState* state = hako_context_state(ctx, false);
+  if (!table || !state || scope == 0 || scope > state->scope_depth) {
+    return -1;
+  }
+
+  int freed = 0;
+  while (state->scope_depth >= scope) {
+    uint32_t mark = state->scope_marks[--state->scope_depth];
+    table->open_scopes--;
+    uint32_t kept = mark;
+    // Freeing a value can run finalizers that allocate, so re-read the log
+    // length on every iteration rather than caching it.
+    for (uint32_t i = mark; i < state->scope_log_len; i++) {
+      uint32_t handle = state->scope_log[i];
+      HakoHandleSlot* slot = hako_handle_lookup(table, handle);
+      if (!slot || slot->scope_ctx != ctx) {
+        continue;
+      }
+      if (slot->scope <= state->scope_depth) {
+        // Promoted into an enclosing scope (or out of scopes entirely)
+        if (slot->scope > 0) {
+          state->scope_log[kept++] = handle;
+        }
+        continue;
+      }
+      LEPUSValue copy = slot->value;
+      hako_handle_release(table, slot);
+      LEPUS_FreeValue(ctx, copy);
+      freed++;
+    }
+    state->scope_log_len = kept;
+  }
+  return freed;
+}
+
+LEPUS_BOOL WASM_EXPORT(HAKO_PromoteValue)(LEPUSContext* ctx,
+                                          LEPUSValueConst* value) {
+  HakoHandleTable* table = hako_handle_table(LEPUS_GetRuntime(ctx));
+  if (!table) {
+    return 0;
+  }
+  HakoHandleSlot* slot = hako_handle_from_value(table, value);
+  if (!slot || slot->scope == 0 || slot->scope_ctx != ctx) {
+    return 0;
+  }
+  slot->scope--;
+  if (slot->scope == 0) {
+    slot->scope_ctx = NULL;
+  }
+  return 1;
 }
 
 void* WASM_EXPORT(HAKO_Malloc)(LEPUSContext* ctx, size_t size) {
@@ -725,6 +2650,225 @@ JSBorrowedChar* WASM_EXPORT(HAKO_ToCString)(LEPUSContext* ctx,
   return LEPUS_ToCString(ctx, *value);
 }
 
+// Transcoding helpers for the length-aware string exports. Lone surrogates
+// are carried through as three-byte sequences, matching what the engine
+// produces and accepts.
+#define HAKO_STRING_STACK_BYTES 256
+
+typedef uint32_t (*HakoTranscodeFn)(const void* src, uint32_t len,
+                                    uint8_t* dst);
+
+static uint32_t hako_utf16_to_utf8(const void* src, uint32_t len,
+                                   uint8_t* dst) {
+  const uint16_t* in = src;
+  uint8_t* out = dst;
+  for (uint32_t i = 0; i < len; i++) {
+    uint32_t c = in[i];
+    if (c < 0x80) {
+      *out++ = (uint8_t)c;
+    } else if (c < 0x800) {
+      *out++ = (uint8_t)(0xC0 | (c >> 6));
+      *out++ = (uint8_t)(0x80 | (c & 0x3F));
+    } else if (c >= 0xD800 && c < 0xDC00 && i + 1 < len &&
+               in[i + 1] >= 0xDC00 && in[i + 1] < 0xE000) {
+      c = 0x10000 + ((c - 0xD800) << 10) + (in[++i] - 0xDC00);
+      *out++ = (uint8_t)(0xF0 | (c >> 18));
+      *out++ = (uint8_t)(0x80 | ((c >> 12) & 0x3F));
+      *out++ = (uint8_t)(0x80 | ((c >> 6) & 0x3F));
+      *out++ = (uint8_t)(0x80 | (c & 0x3F));
+    } else {
+      *out++ = (uint8_t)(0xE0 | (c >> 12));
+      *out++ = (uint8_t)(0x80 | ((c >> 6) & 0x3F));
+      *out++ = (uint8_t)(0x80 | (c & 0x3F));
+    }
+  }
+  return (uint32_t)(out - dst);
+}
+
+// Decodes one code point of engine-produced UTF-8, never reading past end
+static inline uint32_t hako_utf8_next(const uint8_t** p, const uint8_t* end) {
+  const uint8_t* s = *p;
+  uint32_t c = s[0];
+  if (c >= 0xF0 && end - s >= 4) {
+    *p = s + 4;
+    return ((c & 0x07) << 18) | ((s[1] & 0x3F) << 12) |
+           ((s[2] & 0x3F) << 6) | (s[3] & 0x3F);
+  }
+  if (c >= 0xE0 && c < 0xF0 && end - s >= 3) {
+    *p = s + 3;
+    return ((c & 0x0F) << 12) | ((s[1] & 0x3F) << 6) | (s[2] & 0x3F);
+  }
+  if (c >= 0xC0 && c < 0xE0 && end - s >= 2) {
+    *p = s + 2;
+    return ((c & 0x1F) << 6) | (s[1] & 0x3F);
+  }
+  *p = s + 1;
+  return c;
+}
+
+static uint32_t hako_latin1_to_utf8(const void* src, uint32_t len,
+                                    uint8_t* dst) {
+  const uint8_t* in = src;
+  uint8_t* out = dst;
+  for (uint32_t i = 0; i < len; i++) {
+    uint8_t c = in[i];
+    if (c < 0x80) {
+      *out++ = c;
+    } else {
+      *out++ = (uint8_t)(0xC0 | (c >> 6));
+      *out++ = (uint8_t)(0x80 | (c & 0x3F));
+    }
+  }
+  return (uint32_t)(out - dst);
+}
+
+// Builds a string from input transcoded into a stack or heap buffer
+static LEPUSValue hako_new_string_transcoded(LEPUSContext* ctx,
+                                             const void* src, uint32_t len,
+                                             uint32_t max_bytes_per_unit,
+                                             HakoTranscodeFn transcode) {
+  if (len > UINT32_MAX / max_bytes_per_unit) {
+    return LEPUS_ThrowTypeError(ctx, "String too long");
+  }
+  uint32_t capacity = len * max_bytes_per_unit;
+  uint8_t stack_buf[HAKO_STRING_STACK_BYTES];
+  uint8_t* buf = stack_buf;
+  if (capacity > sizeof(stack_buf)) {
+    buf = lepus_malloc(ctx, capacity, ALLOC_TAG_WITHOUT_PTR);
+    if (!buf) {
+      return LEPUS_ThrowOutOfMemory(ctx);
+    }
+  }
+  uint32_t written = transcode(src, len, buf);
+  LEPUSValue result = LEPUS_NewStringLen(ctx, (const char*)buf, written);
+  if (buf != stack_buf) {
+    lepus_free(ctx, buf);
+  }
+  return result;
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_NewStringLen)(LEPUSContext* ctx,
+                                           const char* utf8, uint32_t len) {
+  if (utf8 == NULL && len != 0) {
+    return jsvalue_to_heap(ctx, LEPUS_ThrowTypeError(ctx, "Invalid string"));
+  }
+  return jsvalue_to_heap(ctx, LEPUS_NewStringLen(ctx, len ? utf8 : "", len));
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_NewStringLatin1)(LEPUSContext* ctx,
+                                              const uint8_t* latin1,
+                                              uint32_t len) {
+  if (latin1 == NULL && len != 0) {
+    return jsvalue_to_heap(ctx, LEPUS_ThrowTypeError(ctx, "Invalid string"));
+  }
+  uint32_t ascii = 0;
+  while (ascii < len && latin1[ascii] < 0x80) {
+    ascii++;
+  }
+  if (ascii == len) {
+    // ASCII is already valid UTF-8
+    return jsvalue_to_heap(
+        ctx, LEPUS_NewStringLen(ctx, len ? (const char*)latin1 : "", len));
+  }
+  return jsvalue_to_heap(ctx, hako_new_string_transcoded(
+                                  ctx, latin1, len, 2, hako_latin1_to_utf8));
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_NewStringUTF16)(LEPUSContext* ctx,
+                                             const uint16_t* utf16,
+                                             uint32_t len) {
+  if (utf16 == NULL && len != 0) {
+    return jsvalue_to_heap(ctx, LEPUS_ThrowTypeError(ctx, "Invalid string"));
+  }
+  return jsvalue_to_heap(ctx, hako_new_string_transcoded(
+                                  ctx, utf16, len, 3, hako_utf16_to_utf8));
+}
+
+const void* WASM_EXPORT(HAKO_GetStringView)(LEPUSContext* ctx,
+                                            LEPUSValue* value,
+                                            HakoStringView* out_view) {
+  uint32_t len = 0;
+  int wide = 0;
+  const void* chars = LEPUS_GetStringChars(ctx, value, &len, &wide);
+  if (out_view) {
+    out_view->length = chars ? len : 0;
+    out_view->wide = chars && wide ? 1 : 0;
+  }
+  return chars;
+}
+
+int32_t WASM_EXPORT(HAKO_GetStringUTF8)(LEPUSContext* ctx,
+                                        LEPUSValueConst* value, char* buf,
+                                        uint32_t capacity) {
+  size_t len;
+  const char* str = LEPUS_ToCStringLen(ctx, &len, *value);
+  if (!str) {
+    return -1;
+  }
+  if (buf && capacity) {
+    memcpy(buf, str, len < capacity ? len : capacity);
+  }
+  LEPUS_FreeCString(ctx, str);
+  return (int32_t)len;
+}
+
+int32_t WASM_EXPORT(HAKO_GetStringLatin1)(LEPUSContext* ctx,
+                                          LEPUSValueConst* value, uint8_t* buf,
+                                          uint32_t capacity) {
+  size_t len;
+  const char* str = LEPUS_ToCStringLen(ctx, &len, *value);
+  if (!str) {
+    return -1;
+  }
+  const uint8_t* p = (const uint8_t*)str;
+  const uint8_t* end = p + len;
+  uint32_t count = 0;
+  while (p < end) {
+    uint32_t c = hako_utf8_next(&p, end);
+    if (c > 0xFF) {
+      LEPUS_FreeCString(ctx, str);
+      LEPUS_ThrowTypeError(ctx, "String is not representable in Latin-1");
+      return -1;
+    }
+    if (count < capacity) {
+      buf[count] = (uint8_t)c;
+    }
+    count++;
+  }
+  LEPUS_FreeCString(ctx, str);
+  return (int32_t)count;
+}
+
+int32_t WASM_EXPORT(HAKO_GetStringUTF16)(LEPUSContext* ctx,
+                                         LEPUSValueConst* value, uint16_t* buf,
+                                         uint32_t capacity) {
+  size_t len;
+  const char* str = LEPUS_ToCStringLen(ctx, &len, *value);
+  if (!str) {
+    return -1;
+  }
+  const uint8_t* p = (const uint8_t*)str;
+  const uint8_t* end = p + len;
+  uint32_t count = 0;
+  while (p < end) {
+    uint32_t c = hako_utf8_next(&p, end);
+    if (c >= 0x10000) {
+      c -= 0x10000;
+      if (count < capacity) {
+        buf[count] = (uint16_t)(0xD800 | (c >> 10));
+      }
+      count++;
+      c = 0xDC00 | (c & 0x3FF);
+    }
+    if (count < capacity) {
+      buf[count] = (uint16_t)c;
+    }
+    count++;
+  }
+  LEPUS_FreeCString(ctx, str);
+  return (int32_t)count;
+}
+
 JSVoid* WASM_EXPORT(HAKO_CopyArrayBuffer)(LEPUSContext* ctx,
                                           LEPUSValueConst* data,
                                           size_t* out_length) {
@@ -767,13 +2911,60 @@ LEPUSValue hako_resolve_func_data(LEPUSContext* ctx, LEPUSValueConst this_val,
   return LEPUS_DupValue(ctx, func_data[0]);
 }
 
-LEPUSValue *WASM_EXPORT(HAKO_Eval)(LEPUSContext *ctx, BorrowedHeapChar *js_code,
-                                   size_t js_code_length, BorrowedHeapChar *filename,
-                                   LEPUS_BOOL detect_module,
-                                   EvalFlags eval_flags) {
+void WASM_EXPORT(HAKO_SetScriptCacheLimit)(LEPUSRuntime* rt, uint32_t limit) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (!data) {
+    return;
+  }
+  hako_script_cache_trim(rt, &data->scripts, limit);
+  data->scripts.stats.limit = limit;
+}
+
+void WASM_EXPORT(HAKO_GetScriptCacheStats)(LEPUSRuntime* rt,
+                                           HakoScriptCacheStats* out_stats) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (!out_stats) {
+    return;
+  }
+  if (data) {
+    *out_stats = data->scripts.stats;
+  } else {
+    memset(out_stats, 0, sizeof(*out_stats));
+  }
+}
+
+void WASM_EXPORT(HAKO_PurgeScriptCache)(LEPUSRuntime* rt) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (data) {
+    hako_script_cache_purge(rt, &data->scripts);
+  }
+}
+
+// source_hash, when given, is the script cache hash of js_code already
+// computed by the caller
+static LEPUSValue *hako_eval(LEPUSContext *ctx, BorrowedHeapChar *js_code,
+                             size_t js_code_length, BorrowedHeapChar *filename,
+                             LEPUS_BOOL detect_module, EvalFlags eval_flags,
+                             const uint64_t *source_hash) {
+  HakoScriptCache* cache = hako_script_cache(ctx);
+  HakoScriptCacheEntry* cached = NULL;
+  uint64_t script_hash = 0;
+  if (cache) {
+    script_hash =
+        source_hash
+            ? hako_script_hash_finish(*source_hash, filename, eval_flags,
+                                      detect_module)
+            : hako_script_hash(js_code, js_code_length, filename, eval_flags,
+                               detect_module);
+    cached = hako_script_cache_find(ctx, cache, script_hash, js_code,
+                                    js_code_length, filename, eval_flags,
+                                    detect_module);
+  }
+
   // Only detect module if detection is enabled and module type isn't already
-  // specified
-  if (detect_module && (eval_flags & LEPUS_EVAL_TYPE_MODULE) == 0) {
+  // specified. Cached scripts are known not to be modules.
+  if (!cached && detect_module &&
+      (eval_flags & LEPUS_EVAL_TYPE_MODULE) == 0) {
     if (ends_with(filename, ".mjs") ||
         LEPUS_DetectModule(js_code, js_code_length)) {
       eval_flags |= LEPUS_EVAL_TYPE_MODULE | LEPUS_EVAL_FLAG_STRICT;
@@ -787,6 +2978,7 @@ LEPUSValue *WASM_EXPORT(HAKO_Eval)(LEPUSContext *ctx, BorrowedHeapChar *js_code,
   // Compile and evaluate module code specially
   if (is_module && (eval_flags & LEPUS_EVAL_FLAG_COMPILE_ONLY) == 0)
   {
+    hako_prefetch_imports(ctx, filename, js_code, js_code_length);
     LEPUSValue func_obj = LEPUS_Eval(ctx, js_code, js_code_length, filename,
                                      eval_flags | LEPUS_EVAL_FLAG_COMPILE_ONLY);
     if (LEPUS_IsException(func_obj))
@@ -814,7 +3006,14 @@ LEPUSValue *WASM_EXPORT(HAKO_Eval)(LEPUSContext *ctx, BorrowedHeapChar *js_code,
   else
   {
     // Regular evaluation for non-module code or compile-only
-    eval_result = LEPUS_Eval(ctx, js_code, js_code_length, filename, eval_flags);
+    if (cache && !is_module) {
+      eval_result = hako_script_cache_eval(ctx, cache, cached, script_hash,
+                                           js_code, js_code_length, filename,
+                                           detect_module, eval_flags);
+    } else {
+      eval_result =
+          LEPUS_Eval(ctx, js_code, js_code_length, filename, eval_flags);
+    }
   }
 
   // If we got an exception or not a promise, return it directly
@@ -902,6 +3101,168 @@ LEPUSValue *WASM_EXPORT(HAKO_Eval)(LEPUSContext *ctx, BorrowedHeapChar *js_code,
   __builtin_unreachable();
 }
 
+LEPUSValue *WASM_EXPORT(HAKO_Eval)(LEPUSContext *ctx, BorrowedHeapChar *js_code,
+                                   size_t js_code_length, BorrowedHeapChar *filename,
+                                   LEPUS_BOOL detect_module,
+                                   EvalFlags eval_flags) {
+  return hako_eval(ctx, js_code, js_code_length, filename, detect_module,
+                   eval_flags, NULL);
+}
+
+// Source assembled by HAKO_EvalBufferAppend in a single buffer, since the
+// parser needs the whole source contiguous and null-terminated. Nothing is
+// parsed before HAKO_EvalBufferEnd.
+struct HakoEvalBuffer {
+  LEPUSContext* ctx;
+  char* source;
+  size_t length;
+  size_t capacity;  // Excluding the terminator
+  uint64_t hash;    // Script cache hash of the source appended so far
+};
+
+HakoEvalBuffer* WASM_EXPORT(HAKO_EvalBufferBegin)(LEPUSContext* ctx,
+                                                 size_t size_hint) {
+  // Room for the terminator
+  if (size_hint > SIZE_MAX - 1) {
+    LEPUS_ThrowOutOfMemory(ctx);
+    return NULL;
+  }
+  HakoEvalBuffer* buffer =
+      lepus_malloc(ctx, sizeof(HakoEvalBuffer), ALLOC_TAG_WITHOUT_PTR);
+  if (!buffer) {
+    LEPUS_ThrowOutOfMemory(ctx);
+    return NULL;
+  }
+  buffer->ctx = ctx;
+  buffer->length = 0;
+  buffer->capacity = size_hint;
+  buffer->hash = HAKO_SCRIPT_HASH_SEED;
+  buffer->source = lepus_malloc(ctx, size_hint + 1, ALLOC_TAG_WITHOUT_PTR);
+  if (!buffer->source) {
+    lepus_free(ctx, buffer);
+    LEPUS_ThrowOutOfMemory(ctx);
+    return NULL;
+  }
+  buffer->source[0] = '\0';
+  return buffer;
+}
+
+int WASM_EXPORT(HAKO_EvalBufferAppend)(HakoEvalBuffer* buffer,
+                                       BorrowedHeapChar* chunk,
+                                       size_t chunk_length) {
+  if (!buffer || (!chunk && chunk_length > 0)) {
+    return -1;
+  }
+  LEPUSContext* ctx = buffer->ctx;
+  if (chunk_length > buffer->capacity - buffer->length) {
+    if (chunk_length > SIZE_MAX - 1 - buffer->length) {
+      LEPUS_ThrowOutOfMemory(ctx);
+      return -1;
+    }
+    // Grow geometrically when the size hint was missing or too small
+    size_t capacity = buffer->capacity > (SIZE_MAX - 1) / 2
+                          ? SIZE_MAX - 1
+                          : buffer->capacity * 2;
+    if (capacity < buffer->length + chunk_length) {
+      capacity = buffer->length + chunk_length;
+    }
+    char* source = lepus_malloc(ctx, capacity + 1, ALLOC_TAG_WITHOUT_PTR);
+    if (!source) {
+      LEPUS_ThrowOutOfMemory(ctx);
+      return -1;
+    }
+    memcpy(source, buffer->source, buffer->length);
+    lepus_free(ctx, buffer->source);
+    buffer->source = source;
+    buffer->capacity = capacity;
+  }
+
+  memcpy(buffer->source + buffer->length, chunk, chunk_length);
+  buffer->length += chunk_length;
+  buffer->source[buffer->length] = '\0';
+  // Hash while the chunk is still hot in cache instead of rescanning the
+  // whole source on the script cache lookup
+  buffer->hash = hako_hash_bytes(buffer->hash, chunk, chunk_length);
+  return 0;
+}
+
+void WASM_EXPORT(HAKO_EvalBufferAbort)(HakoEvalBuffer* buffer) {
+  if (buffer) {
+    lepus_free(buffer->ctx, buffer->source);
+    lepus_free(buffer->ctx, buffer);
+  }
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_EvalBufferEnd)(HakoEvalBuffer* buffer,
+                                            BorrowedHeapChar* filename,
+                                            LEPUS_BOOL detect_module,
+                                            EvalFlags eval_flags) {
+  if (!buffer) {
+    return NULL;
+  }
+  LEPUSContext* ctx = buffer->ctx;
+  LEPUSValue* result =
+      filename ? hako_eval(ctx, buffer->source, buffer->length, filename,
+                           detect_module, eval_flags, &buffer->hash)
+               : jsvalue_to_heap(
+                     ctx, LEPUS_ThrowTypeError(ctx, "Invalid arguments"));
+  HAKO_EvalBufferAbort(buffer);
+  return result;
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_PrepareScript)(LEPUSContext* ctx,
+                                            BorrowedHeapChar* js_code,
+                                            size_t js_code_length,
+                                            BorrowedHeapChar* filename,
+                                            EvalFlags eval_flags) {
+  if (!js_code || !filename) {
+    return jsvalue_to_heap(ctx,
+                           LEPUS_ThrowTypeError(ctx, "Invalid arguments"));
+  }
+  if ((eval_flags & LEPUS_EVAL_TYPE_MODULE) != 0) {
+    return jsvalue_to_heap(
+        ctx, LEPUS_ThrowTypeError(ctx, "Modules cannot be prepared"));
+  }
+  eval_flags |= LEPUS_EVAL_FLAG_COMPILE_ONLY;
+
+  // Go through the script cache so preparing the same source in several
+  // contexts compiles it once
+  HakoScriptCache* cache = hako_script_cache(ctx);
+  if (!cache) {
+    return jsvalue_to_heap(
+        ctx, LEPUS_Eval(ctx, js_code, js_code_length, filename, eval_flags));
+  }
+  uint64_t hash = hako_script_hash(js_code, js_code_length, filename,
+                                   eval_flags, FALSE);
+  HakoScriptCacheEntry* cached = hako_script_cache_find(
+      ctx, cache, hash, js_code, js_code_length, filename, eval_flags, FALSE);
+  return jsvalue_to_heap(
+      ctx, hako_script_cache_eval(ctx, cache, cached, hash, js_code,
+                                  js_code_length, filename, FALSE,
+                                  eval_flags));
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_RunPrepared)(LEPUSContext* ctx,
+                                          LEPUSValueConst* prepared,
+                                          LEPUSValueConst* this_obj) {
+  if (!prepared ||
+      LEPUS_VALUE_GET_TAG(*prepared) != LEPUS_TAG_FUNCTION_BYTECODE) {
+    return jsvalue_to_heap(
+        ctx, LEPUS_ThrowTypeError(ctx, "Value is not a prepared script"));
+  }
+
+  // LEPUS_EvalFunction consumes the function, so each run instantiates a
+  // fresh closure from a new reference to the shared bytecode
+  LEPUSValue func = LEPUS_DupValue(ctx, *prepared);
+  if (this_obj) {
+    return jsvalue_to_heap(ctx, LEPUS_EvalFunction(ctx, func, *this_obj));
+  }
+  LEPUSValue global = LEPUS_GetGlobalObject(ctx);
+  LEPUSValue result = LEPUS_EvalFunction(ctx, func, global);
+  LEPUS_FreeValue(ctx, global);
+  return jsvalue_to_heap(ctx, result);
+}
+
 LEPUSValue* WASM_EXPORT(HAKO_NewSymbol)(LEPUSContext* ctx,
                                         BorrowedHeapChar* description,
                                         int isGlobal) {
@@ -1014,12 +3375,11 @@ LEPUS_BOOL WASM_EXPORT(HAKO_SetProp)(LEPUSContext* ctx,
   return result;
 }
 
-LEPUS_BOOL WASM_EXPORT(HAKO_DefineProp)(
-    LEPUSContext* ctx, LEPUSValueConst* this_val, LEPUSValueConst* prop_name,
-    LEPUSValueConst* prop_value, LEPUSValueConst* get, LEPUSValueConst* set,
-    LEPUS_BOOL configurable, LEPUS_BOOL enumerable, LEPUS_BOOL has_value) {
-  LEPUSAtom prop_atom = LEPUS_ValueToAtom(ctx, *prop_name);
-
+static int hako_define_prop(LEPUSContext* ctx, LEPUSValueConst this_val,
+                            LEPUSAtom prop_atom, LEPUSValueConst prop_value,
+                            LEPUSValueConst get, LEPUSValueConst set,
+                            LEPUS_BOOL configurable, LEPUS_BOOL enumerable,
+                            LEPUS_BOOL has_value) {
   int flags = 0;
   if (configurable) {
     flags = flags | LEPUS_PROP_CONFIGURABLE;
@@ -1033,22 +3393,112 @@ LEPUS_BOOL WASM_EXPORT(HAKO_DefineProp)(
       flags = flags | LEPUS_PROP_HAS_ENUMERABLE;
     }
   }
-  if (!LEPUS_IsUndefined(*get)) {
+  if (!LEPUS_IsUndefined(get)) {
     flags = flags | LEPUS_PROP_HAS_GET;
   }
-  if (!LEPUS_IsUndefined(*set)) {
+  if (!LEPUS_IsUndefined(set)) {
     flags = flags | LEPUS_PROP_HAS_SET;
   }
   if (has_value) {
     flags = flags | LEPUS_PROP_HAS_VALUE;
   }
 
-  int result = LEPUS_DefineProperty(ctx, *this_val, prop_atom, *prop_value,
-                                    *get, *set, flags);
+  return LEPUS_DefineProperty(ctx, this_val, prop_atom, prop_value, get, set,
+                              flags);
+}
+
+LEPUS_BOOL WASM_EXPORT(HAKO_DefineProp)(
+    LEPUSContext* ctx, LEPUSValueConst* this_val, LEPUSValueConst* prop_name,
+    LEPUSValueConst* prop_value, LEPUSValueConst* get, LEPUSValueConst* set,
+    LEPUS_BOOL configurable, LEPUS_BOOL enumerable, LEPUS_BOOL has_value) {
+  LEPUSAtom prop_atom = LEPUS_ValueToAtom(ctx, *prop_name);
+  int result = hako_define_prop(ctx, *this_val, prop_atom, *prop_value, *get,
+                                *set, configurable, enumerable, has_value);
   LEPUS_FreeAtom(ctx, prop_atom);
   return result;
 }
 
+LEPUSAtom WASM_EXPORT(HAKO_NewAtom)(LEPUSContext* ctx, const char* utf8,
+                                    size_t len) {
+  return LEPUS_NewAtomLen(ctx, utf8, len);
+}
+
+LEPUSAtom WASM_EXPORT(HAKO_DupAtom)(LEPUSContext* ctx, LEPUSAtom atom) {
+  return LEPUS_DupAtom(ctx, atom);
+}
+
+void WASM_EXPORT(HAKO_FreeAtom)(LEPUSContext* ctx, LEPUSAtom atom) {
+  LEPUS_FreeAtom(ctx, atom);
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_GetPropAtom)(LEPUSContext* ctx,
+                                          LEPUSValueConst* this_val,
+                                          LEPUSAtom prop_atom) {
+  LEPUSValue prop_val = LEPUS_GetProperty(ctx, *this_val, prop_atom);
+  if (LEPUS_IsException(prop_val)) {
+    return NULL;
+  }
+  return jsvalue_to_heap(ctx, prop_val);
+}
+
+LEPUS_BOOL WASM_EXPORT(HAKO_SetPropAtom)(LEPUSContext* ctx,
+                                         LEPUSValueConst* this_val,
+                                         LEPUSAtom prop_atom,
+                                         LEPUSValueConst* prop_value) {
+  return LEPUS_SetProperty(ctx, *this_val, prop_atom,
+                           LEPUS_DupValue(ctx, *prop_value));
+}
+
+LEPUS_BOOL WASM_EXPORT(HAKO_DefinePropAtom)(
+    LEPUSContext* ctx, LEPUSValueConst* this_val, LEPUSAtom prop_atom,
+    LEPUSValueConst* prop_value, LEPUSValueConst* get, LEPUSValueConst* set,
+    LEPUS_BOOL configurable, LEPUS_BOOL enumerable, LEPUS_BOOL has_value) {
+  return hako_define_prop(ctx, *this_val, prop_atom, *prop_value, *get, *set,
+                          configurable, enumerable, has_value);
+}
+
+int WASM_EXPORT(HAKO_GetProps)(LEPUSContext* ctx, LEPUSValueConst* this_val,
+                               const LEPUSAtom* atoms, uint32_t count,
+                               LEPUSValue** out_values, uint8_t* out_status) {
+  int failures = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    LEPUSValue prop_val = LEPUS_GetProperty(ctx, *this_val, atoms[i]);
+    out_status[i] = LEPUS_IsException(prop_val) ? 1 : 0;
+    if (out_status[i]) {
+      // Take the pending exception so the remaining slots can still be read
+      prop_val = LEPUS_GetException(ctx);
+      failures++;
+    }
+    out_values[i] = jsvalue_to_heap(ctx, prop_val);
+  }
+  return failures;
+}
+
+int WASM_EXPORT(HAKO_SetProps)(LEPUSContext* ctx, LEPUSValueConst* this_val,
+                               const LEPUSAtom* atoms, uint32_t count,
+                               LEPUSValueConst* values, uint8_t* out_status,
+                               LEPUSValue** out_errors) {
+  int failures = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    int result = LEPUS_SetProperty(ctx, *this_val, atoms[i],
+                                   LEPUS_DupValue(ctx, values[i]));
+    out_status[i] = result < 0 ? 1 : 0;
+    if (out_errors) {
+      out_errors[i] = NULL;
+    }
+    if (result < 0) {
+      LEPUSValue error = LEPUS_GetException(ctx);
+      if (out_errors) {
+        out_errors[i] = jsvalue_to_heap(ctx, error);
+      } else {
+        LEPUS_FreeValue(ctx, error);
+      }
+      failures++;
+    }
+  }
+  return failures;
+}
+
 static inline bool __JS_AtomIsTaggedInt(LEPUSAtom v) {
   return (v & LEPUS_ATOM_TAG_INT) != 0;
 }
@@ -1091,9 +3541,11 @@ LEPUSValue* WASM_EXPORT(HAKO_GetOwnPropertyNames)(LEPUSContext* ctx,
     return jsvalue_to_heap(ctx, LEPUS_GetException(ctx));
   }
 
-  // Use lepus_malloc instead of malloc
-  *out_ptrs = lepus_malloc(ctx, sizeof(LEPUSValue*) * (*out_len),
-                           ALLOC_TAG_WITHOUT_PTR);
+  // Sized by the enumeration itself; at least one slot so that an empty
+  // object does not look like an allocation failure
+  *out_ptrs = lepus_malloc(
+      ctx, sizeof(LEPUSValue*) * (total_props ? total_props : 1),
+      ALLOC_TAG_WITHOUT_PTR);
   if (!*out_ptrs) {
     lepus_free(ctx, tab);
     return jsvalue_to_heap(ctx, LEPUS_ThrowOutOfMemory(ctx));
@@ -1123,28 +3575,441 @@ LEPUSValue* WASM_EXPORT(HAKO_GetOwnPropertyNames)(LEPUSContext* ctx,
       } else {
         LEPUS_FreeValue(ctx, atom_value);
       }
-    } else {
-      (*out_ptrs)[out_props++] = jsvalue_to_heap(ctx, atom_value);
+    } else {
+      (*out_ptrs)[out_props++] = jsvalue_to_heap(ctx, atom_value);
+    }
+  }
+  lepus_free(ctx, tab);
+  *out_len = out_props;
+  return NULL;
+}
+
+uint8_t* WASM_EXPORT(HAKO_GetOwnPropertyNamesPacked)(LEPUSContext* ctx,
+                                                     LEPUSValueConst* obj,
+                                                     int flags,
+                                                     uint32_t pack_flags,
+                                                     uint32_t* out_len) {
+  if (obj == NULL || out_len == NULL) {
+    LEPUS_ThrowTypeError(ctx, "Invalid arguments");
+    return NULL;
+  }
+  *out_len = 0;
+  if (LEPUS_IsObject(*obj) == false) {
+    LEPUS_ThrowTypeError(ctx, "not an object");
+    return NULL;
+  }
+
+  bool standard_compliant_number =
+      (flags & HAKO_STANDARD_COMPLIANT_NUMBER) != 0;
+  bool include_string = (flags & LEPUS_GPN_STRING_MASK) != 0;
+  bool include_number =
+      standard_compliant_number ? 0 : (flags & HAKO_GPN_NUMBER_MASK) != 0;
+  if (include_number) {
+    flags = flags | LEPUS_GPN_STRING_MASK;
+  }
+  bool include_index =
+      include_number || (include_string && standard_compliant_number);
+
+  LEPUSPropertyEnum* tab = NULL;
+  uint32_t total_props = 0;
+  if (LEPUS_GetOwnPropertyNames(ctx, &tab, &total_props, *obj, flags) < 0) {
+    return NULL;
+  }
+
+  LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+  HakoByteBuffer buf;
+  memset(&buf, 0, sizeof(buf));
+  buf.rt = rt;
+  buf.limit = UINT32_MAX;
+  // Atoms handed to the caller, released again if packing fails
+  uint32_t* owned = NULL;
+  uint32_t owned_len = 0;
+  uint32_t owned_capacity = 0;
+  uint32_t count = 0;
+
+  bool ok = hako_buffer_u32(&buf, 0);
+  for (uint32_t i = 0; ok && i < total_props; i++) {
+    LEPUSAtom atom = tab[i].atom;
+    uint8_t kind;
+    uint32_t slot = 0;
+    if (__JS_AtomIsTaggedInt(atom)) {
+      if (!include_index) {
+        continue;
+      }
+      kind = HAKO_PACKED_KEY_INDEX;
+      slot = __JS_AtomToUInt32(atom);
+    } else {
+      LEPUSValue atom_value = LEPUS_AtomToValue(ctx, atom);
+      bool is_string = LEPUS_IsString(atom_value);
+      LEPUS_FreeValue(ctx, atom_value);
+      if (is_string && !include_string) {
+        continue;
+      }
+      kind = is_string ? HAKO_PACKED_KEY_STRING : HAKO_PACKED_KEY_SYMBOL;
+      // Symbols have no inline form, so they always carry their atom
+      if (!is_string || (pack_flags & HAKO_PACK_KEY_ATOMS)) {
+        if (!hako_u32_reserve(rt, &owned, &owned_capacity, owned_len + 1)) {
+          buf.out_of_memory = true;
+          ok = false;
+          break;
+        }
+        slot = LEPUS_DupAtom(ctx, atom);
+        owned[owned_len++] = slot;
+      }
+    }
+    ok = hako_buffer_u8(&buf, kind) && hako_buffer_u32(&buf, slot);
+    if (ok && kind == HAKO_PACKED_KEY_STRING &&
+        (pack_flags & HAKO_PACK_KEY_UTF8)) {
+      size_t len;
+      const char* str = LEPUS_AtomToCStringLen(ctx, &len, atom);
+      if (!str) {
+        ok = false;
+        break;
+      }
+      ok = hako_buffer_u32(&buf, (uint32_t)len) &&
+           hako_buffer_write(&buf, str, (uint32_t)len);
+      LEPUS_FreeCString(ctx, str);
+    }
+    count++;
+  }
+  if (buf.out_of_memory) {
+    LEPUS_ThrowOutOfMemory(ctx);
+  }
+
+  for (uint32_t i = 0; i < total_props; i++) {
+    LEPUS_FreeAtom(ctx, tab[i].atom);
+  }
+  lepus_free(ctx, tab);
+  if (!ok) {
+    for (uint32_t i = 0; i < owned_len; i++) {
+      LEPUS_FreeAtom(ctx, owned[i]);
+    }
+    lepus_free_rt(rt, owned);
+    lepus_free_rt(rt, buf.data);
+    return NULL;
+  }
+  lepus_free_rt(rt, owned);
+  memcpy(buf.data, &count, sizeof(count));
+  *out_len = buf.len;
+  return buf.data;
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_Call)(LEPUSContext* ctx, LEPUSValueConst* func_obj,
+                                   LEPUSValueConst* this_obj, int argc,
+                                   LEPUSValueConst** argv_ptrs) {
+  LEPUSValueConst argv[argc];
+  int i;
+  for (i = 0; i < argc; i++) {
+    argv[i] = *(argv_ptrs[i]);
+  }
+
+  return jsvalue_to_heap(ctx,
+                         LEPUS_Call(ctx, *func_obj, *this_obj, argc, argv));
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_GetScratchArgv)(LEPUSContext* ctx,
+                                             uint32_t argc) {
+  if (argc == 0 || argc > HAKO_SCRATCH_ARGV_MAX) {
+    return NULL;
+  }
+  HakoContextState* state = hako_context_state(ctx, true);
+  if (!state) {
+    return NULL;
+  }
+  if (argc > state->scratch_argv_capacity) {
+    uint32_t capacity =
+        state->scratch_argv_capacity ? state->scratch_argv_capacity : 16;
+    while (capacity < argc) {
+      capacity *= 2;
+    }
+    LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+    LEPUSValue* argv = lepus_malloc_rt(rt, sizeof(LEPUSValue) * capacity,
+                                       ALLOC_TAG_WITHOUT_PTR);
+    if (!argv) {
+      return NULL;
+    }
+    lepus_free_rt(rt, state->scratch_argv);
+    state->scratch_argv = argv;
+    state->scratch_argv_capacity = capacity;
+  }
+  return state->scratch_argv;
+}
+
+// Resolves the argv for the *Argv call exports. A NULL argv selects the
+// context scratch buffer, which is copied into argv_copy so that re-entrant
+// calls from the callee can reuse the buffer while this call is running.
+#define HAKO_ARGV_COPY_LEN(argv, argc)                           \
+  ((argv) == NULL && (argc) > 0 && (argc) <= HAKO_SCRATCH_ARGV_MAX \
+       ? (argc)                                                    \
+       : 1)
+
+static bool hako_resolve_argv(LEPUSContext* ctx, int argc,
+                              LEPUSValueConst** argv,
+                              LEPUSValueConst* argv_copy) {
+  if (argc < 0) {
+    LEPUS_ThrowTypeError(ctx, "Invalid argument count");
+    return false;
+  }
+  if (*argv != NULL || argc == 0) {
+    return true;
+  }
+  // Only the scratch path is capped, since argv_copy lives on the stack
+  if (argc > HAKO_SCRATCH_ARGV_MAX) {
+    LEPUS_ThrowTypeError(ctx, "Too many arguments for the scratch argv");
+    return false;
+  }
+  HakoContextState* state = hako_context_state(ctx, false);
+  if (!state || state->scratch_argv_capacity < (uint32_t)argc) {
+    LEPUS_ThrowTypeError(ctx, "Scratch argv buffer is too small");
+    return false;
+  }
+  memcpy(argv_copy, state->scratch_argv, sizeof(LEPUSValue) * argc);
+  *argv = argv_copy;
+  return true;
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_CallArgv)(LEPUSContext* ctx,
+                                       LEPUSValueConst* func_obj,
+                                       LEPUSValueConst* this_obj, int argc,
+                                       LEPUSValueConst* argv) {
+  LEPUSValueConst argv_copy[HAKO_ARGV_COPY_LEN(argv, argc)];
+  if (!hako_resolve_argv(ctx, argc, &argv, argv_copy)) {
+    return jsvalue_to_heap(ctx, LEPUS_EXCEPTION);
+  }
+  return jsvalue_to_heap(ctx,
+                         LEPUS_Call(ctx, *func_obj, *this_obj, argc, argv));
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_CallConstructorArgv)(LEPUSContext* ctx,
+                                                  LEPUSValueConst* func_obj,
+                                                  int argc,
+                                                  LEPUSValueConst* argv) {
+  LEPUSValueConst argv_copy[HAKO_ARGV_COPY_LEN(argv, argc)];
+  if (!hako_resolve_argv(ctx, argc, &argv, argv_copy)) {
+    return jsvalue_to_heap(ctx, LEPUS_EXCEPTION);
+  }
+  return jsvalue_to_heap(ctx,
+                         LEPUS_CallConstructor(ctx, *func_obj, argc, argv));
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_InvokeArgv)(LEPUSContext* ctx,
+                                         LEPUSValueConst* this_obj,
+                                         LEPUSAtom atom, int argc,
+                                         LEPUSValueConst* argv) {
+  LEPUSValueConst argv_copy[HAKO_ARGV_COPY_LEN(argv, argc)];
+  if (!hako_resolve_argv(ctx, argc, &argv, argv_copy)) {
+    return jsvalue_to_heap(ctx, LEPUS_EXCEPTION);
+  }
+  return jsvalue_to_heap(ctx, LEPUS_Invoke(ctx, *this_obj, atom, argc, argv));
+}
+
+static inline void hako_batch_store(LEPUSContext* ctx, LEPUSValue* regs,
+                                    uint32_t reg, LEPUSValue value) {
+  LEPUS_FreeValue(ctx, regs[reg]);
+  regs[reg] = value;
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_ExecBatch)(LEPUSContext* ctx, const uint32_t* ops,
+                                        uint32_t ops_len,
+                                        uint32_t register_count, uint32_t* out,
+                                        uint32_t out_len) {
+  if (ops == NULL || register_count == 0 ||
+      register_count > HAKO_BATCH_MAX_REGISTERS ||
+      (out == NULL && out_len > 0)) {
+    return jsvalue_to_heap(ctx, LEPUS_ThrowTypeError(ctx, "Invalid arguments"));
+  }
+
+  LEPUSValue regs[register_count];
+  for (uint32_t i = 0; i < register_count; i++) {
+    regs[i] = LEPUS_UNDEFINED;
+  }
+  if (out_len > 0) {
+    memset(out, 0, sizeof(uint32_t) * out_len);
+  }
+
+// Operand accessors; every register index is bounds-checked before use
+#define BATCH_NEED(n)         \
+  do {                        \
+    if (pc + (n) > ops_len) { \
+      goto malformed;         \
+    }                         \
+  } while (0)
+#define BATCH_REG(i, dst)                  \
+  do {                                     \
+    if (ops[pc + (i)] >= register_count) { \
+      goto malformed;                      \
+    }                                      \
+    dst = ops[pc + (i)];                   \
+  } while (0)
+
+  uint32_t pc = 0;
+  uint32_t out_pos = 0;
+  uint32_t start = 0;
+  while (pc < ops_len) {
+    start = pc;
+    uint32_t dst, obj, key, val;
+    switch ((HAKO_BatchOp)ops[pc]) {
+      case HAKO_BATCH_LOAD: {
+        BATCH_NEED(3);
+        BATCH_REG(1, dst);
+        LEPUSValueConst* src = (LEPUSValueConst*)(uintptr_t)ops[pc + 2];
+        if (src == NULL) {
+          goto malformed;
+        }
+        hako_batch_store(ctx, regs, dst, LEPUS_DupValue(ctx, *src));
+        pc += 3;
+        break;
+      }
+      case HAKO_BATCH_LOAD_STRING: {
+        BATCH_NEED(3);
+        BATCH_REG(1, dst);
+        CString* str = (CString*)(uintptr_t)ops[pc + 2];
+        if (str == NULL) {
+          goto malformed;
+        }
+        LEPUSValue result = LEPUS_NewString(ctx, str);
+        if (LEPUS_IsException(result)) {
+          goto fail;
+        }
+        hako_batch_store(ctx, regs, dst, result);
+        pc += 3;
+        break;
+      }
+      case HAKO_BATCH_LOAD_INT: {
+        BATCH_NEED(3);
+        BATCH_REG(1, dst);
+        hako_batch_store(ctx, regs, dst,
+                         LEPUS_NewInt32(ctx, (int32_t)ops[pc + 2]));
+        pc += 3;
+        break;
+      }
+      case HAKO_BATCH_GET: {
+        BATCH_NEED(4);
+        BATCH_REG(1, dst);
+        BATCH_REG(2, obj);
+        BATCH_REG(3, key);
+        LEPUSAtom atom = LEPUS_ValueToAtom(ctx, regs[key]);
+        if (atom == LEPUS_ATOM_NULL) {
+          goto fail;
+        }
+        LEPUSValue result = LEPUS_GetProperty(ctx, regs[obj], atom);
+        LEPUS_FreeAtom(ctx, atom);
+        if (LEPUS_IsException(result)) {
+          goto fail;
+        }
+        hako_batch_store(ctx, regs, dst, result);
+        pc += 4;
+        break;
+      }
+      case HAKO_BATCH_SET:
+      case HAKO_BATCH_DEFINE: {
+        BATCH_NEED(4);
+        BATCH_REG(1, obj);
+        BATCH_REG(2, key);
+        BATCH_REG(3, val);
+        LEPUSAtom atom = LEPUS_ValueToAtom(ctx, regs[key]);
+        if (atom == LEPUS_ATOM_NULL) {
+          goto fail;
+        }
+        LEPUSValue copy = LEPUS_DupValue(ctx, regs[val]);
+        int flags = LEPUS_PROP_C_W_E | LEPUS_PROP_THROW;
+        int result =
+            ops[pc] == HAKO_BATCH_SET
+                ? LEPUS_SetProperty(ctx, regs[obj], atom, copy)
+                : LEPUS_DefinePropertyValue(ctx, regs[obj], atom, copy, flags);
+        LEPUS_FreeAtom(ctx, atom);
+        if (result < 0) {
+          goto fail;
+        }
+        pc += 4;
+        break;
+      }
+      case HAKO_BATCH_CALL:
+      case HAKO_BATCH_NEW: {
+        bool is_new = ops[pc] == HAKO_BATCH_NEW;
+        uint32_t fixed = is_new ? 4 : 5;  // op, dst, func, [this,] argc
+        BATCH_NEED(fixed);
+        BATCH_REG(1, dst);
+        BATCH_REG(2, obj);
+        uint32_t this_reg = 0;
+        if (!is_new) {
+          BATCH_REG(3, this_reg);
+        }
+        uint32_t argc = ops[pc + fixed - 1];
+        if (argc > register_count) {
+          goto malformed;
+        }
+        BATCH_NEED(fixed + argc);
+        LEPUSValueConst argv[argc + 1];
+        for (uint32_t i = 0; i < argc; i++) {
+          uint32_t arg;
+          BATCH_REG(fixed + i, arg);
+          argv[i] = regs[arg];
+        }
+        LEPUSValue result =
+            is_new ? LEPUS_CallConstructor(ctx, regs[obj], argc, argv)
+                   : LEPUS_Call(ctx, regs[obj], regs[this_reg], argc, argv);
+        if (LEPUS_IsException(result)) {
+          goto fail;
+        }
+        hako_batch_store(ctx, regs, dst, result);
+        pc += fixed + argc;
+        break;
+      }
+      case HAKO_BATCH_TYPEOF: {
+        BATCH_NEED(2);
+        BATCH_REG(1, val);
+        if (out_pos >= out_len) {
+          goto malformed;
+        }
+        out[out_pos++] = (uint32_t)LEPUS_GetTypeOf(ctx, &regs[val]);
+        pc += 2;
+        break;
+      }
+      case HAKO_BATCH_FREE: {
+        BATCH_NEED(2);
+        BATCH_REG(1, val);
+        hako_batch_store(ctx, regs, val, LEPUS_UNDEFINED);
+        pc += 2;
+        break;
+      }
+      case HAKO_BATCH_EXPORT: {
+        BATCH_NEED(2);
+        BATCH_REG(1, val);
+        if (out_pos >= out_len) {
+          goto malformed;
+        }
+        LEPUSValue* boxed = jsvalue_to_heap(ctx, regs[val]);
+        if (boxed == NULL) {
+          goto fail;
+        }
+        regs[val] = LEPUS_UNDEFINED;
+        out[out_pos++] = (uint32_t)(uintptr_t)boxed;
+        pc += 2;
+        break;
+      }
+      default:
+        goto malformed;
     }
   }
-  lepus_free(ctx, tab);
-  *out_len = out_props;
-  return NULL;
-}
 
-LEPUSValue* WASM_EXPORT(HAKO_Call)(LEPUSContext* ctx, LEPUSValueConst* func_obj,
-                                   LEPUSValueConst* this_obj, int argc,
-                                   LEPUSValueConst** argv_ptrs) {
-  LEPUSValueConst argv[argc];
-  int i;
-  for (i = 0; i < argc; i++) {
-    argv[i] = *(argv_ptrs[i]);
+  for (uint32_t i = 0; i < register_count; i++) {
+    LEPUS_FreeValue(ctx, regs[i]);
   }
+  return NULL;
 
-  return jsvalue_to_heap(ctx,
-                         LEPUS_Call(ctx, *func_obj, *this_obj, argc, argv));
+malformed:
+  LEPUS_ThrowTypeError(ctx, "Invalid batch instruction at offset %u", start);
+fail:
+  for (uint32_t i = 0; i < register_count; i++) {
+    LEPUS_FreeValue(ctx, regs[i]);
+  }
+  return jsvalue_to_heap(ctx, LEPUS_EXCEPTION);
 }
 
+#undef BATCH_NEED
+#undef BATCH_REG
+
 LEPUSValue* WASM_EXPORT(HAKO_GetLastError)(LEPUSContext* ctx,
                                            LEPUSValue* maybe_exception) {
   // If maybe_exception is provided
@@ -1301,6 +4166,72 @@ LEPUS_BOOL WASM_EXPORT(HAKO_IsNull)(LEPUSValueConst* value) {
   return LEPUS_IsNull(*value);
 }
 
+// Raw values are passed across the boundary as a single i64, which relies on
+// the NaN-boxed LEPUSValue layout used on wasm32.
+#ifdef __wasm32__
+_Static_assert(sizeof(LEPUSValue) == sizeof(uint64_t),
+               "raw value exports require NaN-boxed LEPUSValue");
+#endif
+
+LEPUSValue WASM_EXPORT(HAKO_ValueToRaw)(LEPUSValueConst* value) {
+  return *value;
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_RawToValue)(LEPUSContext* ctx,
+                                         LEPUSValueConst value) {
+  return jsvalue_to_heap(ctx, LEPUS_DupValue(ctx, value));
+}
+
+LEPUSValue WASM_EXPORT(HAKO_GetUndefinedRaw)() {
+  return LEPUS_UNDEFINED;
+}
+
+LEPUSValue WASM_EXPORT(HAKO_GetNullRaw)() {
+  return LEPUS_NULL;
+}
+
+LEPUSValue WASM_EXPORT(HAKO_NewBoolRaw)(LEPUSContext* ctx, int value) {
+  return LEPUS_NewBool(ctx, value);
+}
+
+LEPUSValue WASM_EXPORT(HAKO_NewFloat64Raw)(LEPUSContext* ctx, double num) {
+  return LEPUS_NewFloat64(ctx, num);
+}
+
+double WASM_EXPORT(HAKO_GetFloat64Raw)(LEPUSContext* ctx,
+                                       LEPUSValueConst value) {
+  double result = NAN;
+  LEPUS_ToFloat64(ctx, &result, value);
+  return result;
+}
+
+HAKOTypeOf WASM_EXPORT(HAKO_TypeOfRaw)(LEPUSContext* ctx,
+                                       LEPUSValueConst value) {
+  return (HAKOTypeOf)LEPUS_GetTypeOf(ctx, &value);
+}
+
+LEPUS_BOOL WASM_EXPORT(HAKO_IsNullRaw)(LEPUSValueConst value) {
+  return LEPUS_IsNull(value);
+}
+
+LEPUS_BOOL WASM_EXPORT(HAKO_IsUndefinedRaw)(LEPUSValueConst value) {
+  return LEPUS_IsUndefined(value);
+}
+
+LEPUS_BOOL WASM_EXPORT(HAKO_SetPropRaw)(LEPUSContext* ctx,
+                                        LEPUSValueConst* this_val,
+                                        LEPUSValueConst* prop_name,
+                                        LEPUSValueConst prop_value) {
+  return HAKO_SetProp(ctx, this_val, prop_name, &prop_value);
+}
+
+LEPUS_BOOL WASM_EXPORT(HAKO_SetPropAtomRaw)(LEPUSContext* ctx,
+                                            LEPUSValueConst* this_val,
+                                            LEPUSAtom prop_atom,
+                                            LEPUSValueConst prop_value) {
+  return HAKO_SetPropAtom(ctx, this_val, prop_atom, &prop_value);
+}
+
 LEPUSAtom HAKO_AtomLength = 0;
 int WASM_EXPORT(HAKO_GetLength)(LEPUSContext* ctx, uint32_t* out_len,
                                 LEPUSValueConst* value) {
@@ -1380,6 +4311,661 @@ uint64_t WASM_EXPORT(HAKO_GetPrimjsVersion)() {
   return LEPUS_GetPrimjsVersion();
 }
 
+// Native graph encoding
+//
+// HAKO_ToNative and HAKO_FromNative exchange whole value graphs as a tagged
+// byte stream (see HAKO_NativeTag) so an object tree crosses the boundary in
+// a single call instead of one call per property.
+
+// Open addressing map from non-zero pointer-sized keys to indices
+typedef struct HakoIndexMap {
+  uintptr_t* keys;
+  uint32_t* values;
+  uint32_t count;
+  uint32_t capacity;  // Always a power of two
+} HakoIndexMap;
+
+static inline uint32_t hako_index_map_slot(uintptr_t key, uint32_t capacity) {
+  uint32_t hash = (uint32_t)key ^ (uint32_t)((uint64_t)key >> 32);
+  hash = (hash ^ (hash >> 16)) * 0x45d9f3bu;
+  return (hash ^ (hash >> 16)) & (capacity - 1);
+}
+
+static bool hako_index_map_get(HakoIndexMap* map, uintptr_t key,
+                               uint32_t* value) {
+  if (map->capacity == 0) {
+    return false;
+  }
+  for (uint32_t i = hako_index_map_slot(key, map->capacity);;
+       i = (i + 1) & (map->capacity - 1)) {
+    if (map->keys[i] == 0) {
+      return false;
+    }
+    if (map->keys[i] == key) {
+      *value = map->values[i];
+      return true;
+    }
+  }
+}
+
+static bool hako_index_map_put(LEPUSRuntime* rt, HakoIndexMap* map,
+                               uintptr_t key, uint32_t value) {
+  if ((map->count + 1) * 2 > map->capacity) {
+    uint32_t capacity = map->capacity ? map->capacity * 2 : 64;
+    uintptr_t* keys = lepus_malloc_rt(rt, sizeof(uintptr_t) * capacity,
+                                      ALLOC_TAG_WITHOUT_PTR);
+    uint32_t* values = lepus_malloc_rt(rt, sizeof(uint32_t) * capacity,
+                                       ALLOC_TAG_WITHOUT_PTR);
+    if (!keys || !values) {
+      lepus_free_rt(rt, keys);
+      lepus_free_rt(rt, values);
+      return false;
+    }
+    memset(keys, 0, sizeof(uintptr_t) * capacity);
+    for (uint32_t i = 0; i < map->capacity; i++) {
+      if (map->keys[i] != 0) {
+        uint32_t slot = hako_index_map_slot(map->keys[i], capacity);
+        while (keys[slot] != 0) {
+          slot = (slot + 1) & (capacity - 1);
+        }
+        keys[slot] = map->keys[i];
+        values[slot] = map->values[i];
+      }
+    }
+    lepus_free_rt(rt, map->keys);
+    lepus_free_rt(rt, map->values);
+    map->keys = keys;
+    map->values = values;
+    map->capacity = capacity;
+  }
+  uint32_t slot = hako_index_map_slot(key, map->capacity);
+  while (map->keys[slot] != 0 && map->keys[slot] != key) {
+    slot = (slot + 1) & (map->capacity - 1);
+  }
+  if (map->keys[slot] == 0) {
+    map->count++;
+  }
+  map->keys[slot] = key;
+  map->values[slot] = value;
+  return true;
+}
+
+static void hako_index_map_free(LEPUSRuntime* rt, HakoIndexMap* map) {
+  lepus_free_rt(rt, map->keys);
+  lepus_free_rt(rt, map->values);
+  memset(map, 0, sizeof(*map));
+}
+
+typedef struct HakoNativeWriter {
+  LEPUSContext* ctx;
+  HakoByteBuffer out;
+  HakoIndexMap objects;  // Object pointer -> index, for HAKO_NATIVE_REF
+  HakoIndexMap keys;     // Duplicated atom -> key table index
+  LEPUSValue* retained;  // References to the objects in the objects map
+  uint32_t retained_capacity;
+  uint32_t object_count;
+  uint32_t key_count;
+  uint32_t max_depth;
+  uint32_t flags;
+  uint32_t* opaque;  // Boxed HAKO_NATIVE_OPAQUE values, released on failure
+  uint32_t opaque_len;
+  uint32_t opaque_capacity;
+} HakoNativeWriter;
+
+// Objects currently being written, innermost first, used to tell cycles
+// apart from shared references
+typedef struct HakoNativeFrame {
+  uintptr_t object;
+  const struct HakoNativeFrame* parent;
+} HakoNativeFrame;
+
+static bool hako_native_write(HakoNativeWriter* w, LEPUSValueConst value,
+                              uint32_t depth, const HakoNativeFrame* parent);
+
+static bool hako_native_write_string(HakoNativeWriter* w, const char* str,
+                                     size_t len) {
+  return hako_buffer_u32(&w->out, (uint32_t)len) &&
+         hako_buffer_write(&w->out, str, (uint32_t)len);
+}
+
+static bool hako_native_write_key(HakoNativeWriter* w, LEPUSAtom atom) {
+  uint32_t index;
+  if (hako_index_map_get(&w->keys, atom, &index)) {
+    return hako_buffer_u32(&w->out, index);
+  }
+  size_t len;
+  const char* str = LEPUS_AtomToCStringLen(w->ctx, &len, atom);
+  if (!str) {
+    return false;
+  }
+  bool ok = hako_buffer_u32(&w->out, HAKO_NATIVE_NEW_KEY) &&
+            hako_native_write_string(w, str, len);
+  LEPUS_FreeCString(w->ctx, str);
+  if (!ok) {
+    return false;
+  }
+  // The map holds its own atom reference, so a freed and recycled atom can
+  // never alias an earlier key
+  LEPUS_DupAtom(w->ctx, atom);
+  if (!hako_index_map_put(LEPUS_GetRuntime(w->ctx), &w->keys, atom,
+                          w->key_count)) {
+    LEPUS_FreeAtom(w->ctx, atom);
+    LEPUS_ThrowOutOfMemory(w->ctx);
+    return false;
+  }
+  w->key_count++;
+  return true;
+}
+
+static bool hako_native_write_opaque(HakoNativeWriter* w,
+                                     LEPUSValueConst value) {
+  LEPUSRuntime* rt = LEPUS_GetRuntime(w->ctx);
+  if (!hako_u32_reserve(rt, &w->opaque, &w->opaque_capacity,
+                        w->opaque_len + 1)) {
+    LEPUS_ThrowOutOfMemory(w->ctx);
+    return false;
+  }
+  LEPUSValue* boxed = jsvalue_to_heap(w->ctx, LEPUS_DupValue(w->ctx, value));
+  if (!boxed) {
+    return false;
+  }
+  w->opaque[w->opaque_len++] = (uint32_t)(uintptr_t)boxed;
+  return hako_buffer_u8(&w->out, HAKO_NATIVE_OPAQUE) &&
+         hako_buffer_u32(&w->out, (uint32_t)(uintptr_t)boxed);
+}
+
+static bool hako_native_write_object(HakoNativeWriter* w, LEPUSValueConst obj,
+                                     uint32_t depth,
+                                     const HakoNativeFrame* parent) {
+  LEPUSContext* ctx = w->ctx;
+  uintptr_t ptr = (uintptr_t)LEPUS_VALUE_GET_PTR(obj);
+  uint32_t index;
+  if (hako_index_map_get(&w->objects, ptr, &index)) {
+    if (w->flags & HAKO_NATIVE_REJECT_CYCLES) {
+      for (const HakoNativeFrame* f = parent; f; f = f->parent) {
+        if (f->object == ptr) {
+          LEPUS_ThrowTypeError(ctx, "Cannot convert a cyclic value graph");
+          return false;
+        }
+      }
+    }
+    return hako_buffer_u8(&w->out, HAKO_NATIVE_REF) &&
+           hako_buffer_u32(&w->out, index);
+  }
+  if (depth >= w->max_depth) {
+    LEPUS_ThrowTypeError(ctx, "Value graph exceeds the maximum depth of %u",
+                         w->max_depth);
+    return false;
+  }
+  // Like the key table, the map holds a reference to every object it
+  // indexes: a getter result freed mid-walk must not have its address
+  // reused by a later object, which would be written as a false reference
+  LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+  if (w->object_count == w->retained_capacity) {
+    uint32_t capacity = w->retained_capacity ? w->retained_capacity * 2 : 64;
+    LEPUSValue* retained = lepus_malloc_rt(rt, sizeof(LEPUSValue) * capacity,
+                                           ALLOC_TAG_WITHOUT_PTR);
+    if (!retained) {
+      LEPUS_ThrowOutOfMemory(ctx);
+      return false;
+    }
+    if (w->retained) {
+      memcpy(retained, w->retained, sizeof(LEPUSValue) * w->object_count);
+      lepus_free_rt(rt, w->retained);
+    }
+    w->retained = retained;
+    w->retained_capacity = capacity;
+  }
+  if (!hako_index_map_put(rt, &w->objects, ptr, w->object_count)) {
+    LEPUS_ThrowOutOfMemory(ctx);
+    return false;
+  }
+  w->retained[w->object_count++] = LEPUS_DupValue(ctx, obj);
+  HakoNativeFrame frame = {ptr, parent};
+
+  int is_array = LEPUS_IsArray(ctx, obj);
+  if (is_array < 0) {
+    return false;
+  }
+  if (is_array) {
+    uint32_t len;
+    if (HAKO_GetLength(ctx, &len, &obj) < 0) {
+      return false;
+    }
+    if (!hako_buffer_u8(&w->out, HAKO_NATIVE_ARRAY) ||
+        !hako_buffer_u32(&w->out, len)) {
+      return false;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+      LEPUSValue item = LEPUS_GetPropertyUint32(ctx, obj, i);
+      if (LEPUS_IsException(item)) {
+        return false;
+      }
+      bool ok = hako_native_write(w, item, depth + 1, &frame);
+      LEPUS_FreeValue(ctx, item);
+      if (!ok) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  LEPUSPropertyEnum* tab = NULL;
+  uint32_t len = 0;
+  if (LEPUS_GetOwnPropertyNames(ctx, &tab, &len, obj,
+                                LEPUS_GPN_STRING_MASK | LEPUS_GPN_ENUM_ONLY) <
+      0) {
+    return false;
+  }
+  bool ok = hako_buffer_u8(&w->out, HAKO_NATIVE_OBJECT) &&
+            hako_buffer_u32(&w->out, len);
+  for (uint32_t i = 0; ok && i < len; i++) {
+    LEPUSValue item = LEPUS_GetProperty(ctx, obj, tab[i].atom);
+    if (LEPUS_IsException(item)) {
+      ok = false;
+      break;
+    }
+    ok = hako_native_write_key(w, tab[i].atom) &&
+         hako_native_write(w, item, depth + 1, &frame);
+    LEPUS_FreeValue(ctx, item);
+  }
+  LEPUS_FreePropertyEnum(ctx, tab, len);
+  return ok;
+}
+
+static bool hako_native_write(HakoNativeWriter* w, LEPUSValueConst value,
+                              uint32_t depth, const HakoNativeFrame* parent) {
+  LEPUSContext* ctx = w->ctx;
+  if (LEPUS_IsUndefined(value)) {
+    return hako_buffer_u8(&w->out, HAKO_NATIVE_UNDEFINED);
+  }
+  if (LEPUS_IsNull(value)) {
+    return hako_buffer_u8(&w->out, HAKO_NATIVE_NULL);
+  }
+  if (LEPUS_IsBool(value)) {
+    return hako_buffer_u8(&w->out, LEPUS_VALUE_GET_BOOL(value)
+                                       ? HAKO_NATIVE_TRUE
+                                       : HAKO_NATIVE_FALSE);
+  }
+  if (LEPUS_VALUE_GET_TAG(value) == LEPUS_TAG_INT) {
+    return hako_buffer_u8(&w->out, HAKO_NATIVE_INT32) &&
+           hako_buffer_u32(&w->out, (uint32_t)LEPUS_VALUE_GET_INT(value));
+  }
+  if (LEPUS_IsNumber(value)) {
+    double num = NAN;
+    LEPUS_ToFloat64(ctx, &num, value);
+    return hako_buffer_u8(&w->out, HAKO_NATIVE_FLOAT64) &&
+           hako_buffer_f64(&w->out, num);
+  }
+
+  HAKOTypeOf type = (HAKOTypeOf)LEPUS_GetTypeOf(ctx, &value);
+  if (LEPUS_IsString(value) || type == HAKO_TYPE_BIGINT) {
+    size_t len;
+    const char* str = LEPUS_ToCStringLen(ctx, &len, value);
+    if (!str) {
+      return false;
+    }
+    bool ok = hako_buffer_u8(&w->out, LEPUS_IsString(value)
+                                          ? HAKO_NATIVE_STRING
+                                          : HAKO_NATIVE_BIGINT) &&
+              hako_native_write_string(w, str, len);
+    LEPUS_FreeCString(ctx, str);
+    return ok;
+  }
+  if (type == HAKO_TYPE_OBJECT && LEPUS_IsObject(value)) {
+    return hako_native_write_object(w, value, depth, parent);
+  }
+  // Functions, symbols and anything else without a data representation
+  return hako_native_write_opaque(w, value);
+}
+
+uint8_t* WASM_EXPORT(HAKO_ToNative)(LEPUSContext* ctx, LEPUSValueConst* value,
+                                    uint32_t max_depth, uint32_t max_bytes,
+                                    uint32_t flags, uint32_t* out_len) {
+  if (value == NULL || out_len == NULL) {
+    LEPUS_ThrowTypeError(ctx, "Invalid arguments");
+    return NULL;
+  }
+  *out_len = 0;
+
+  LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+  HakoNativeWriter w;
+  memset(&w, 0, sizeof(w));
+  w.ctx = ctx;
+  w.out.rt = rt;
+  w.out.limit = max_bytes ? max_bytes : UINT32_MAX;
+  w.max_depth = max_depth ? max_depth : HAKO_NATIVE_DEFAULT_MAX_DEPTH;
+  w.flags = flags;
+
+  bool ok = hako_buffer_u8(&w.out, HAKO_NATIVE_VERSION) &&
+            hako_native_write(&w, *value, 0, NULL);
+  // Buffer failures are the only ones without a pending exception
+  if (w.out.over_limit) {
+    LEPUS_ThrowTypeError(ctx, "Value graph exceeds the limit of %u bytes",
+                         w.out.limit);
+  } else if (w.out.out_of_memory) {
+    LEPUS_ThrowOutOfMemory(ctx);
+  }
+
+  for (uint32_t i = 0; i < w.keys.capacity; i++) {
+    if (w.keys.keys[i] != 0) {
+      LEPUS_FreeAtom(ctx, (LEPUSAtom)w.keys.keys[i]);
+    }
+  }
+  hako_index_map_free(rt, &w.keys);
+  hako_index_map_free(rt, &w.objects);
+  for (uint32_t i = 0; i < w.object_count; i++) {
+    LEPUS_FreeValue(ctx, w.retained[i]);
+  }
+  lepus_free_rt(rt, w.retained);
+  if (!ok) {
+    for (uint32_t i = 0; i < w.opaque_len; i++) {
+      HAKO_FreeValuePointer(ctx, (LEPUSValue*)(uintptr_t)w.opaque[i]);
+    }
+    lepus_free_rt(rt, w.out.data);
+  }
+  lepus_free_rt(rt, w.opaque);
+  if (!ok) {
+    return NULL;
+  }
+  *out_len = w.out.len;
+  return w.out.data;
+}
+
+typedef struct HakoNativeReader {
+  LEPUSContext* ctx;
+  const uint8_t* data;
+  uint32_t len;
+  uint32_t pos;
+  uint32_t max_depth;
+  uint32_t* keys;  // Key table index -> owned atom
+  uint32_t key_count;
+  uint32_t key_capacity;
+  LEPUSValue* objects;  // Borrowed, kept alive by the graph being built
+  uint32_t object_count;
+  uint32_t object_capacity;
+  LEPUSValue bigint_ctor;
+} HakoNativeReader;
+
+static LEPUSValue hako_native_read(HakoNativeReader* r, uint32_t depth);
+
+static bool hako_native_read_bytes(HakoNativeReader* r, void* dst,
+                                   uint32_t size) {
+  if (size > r->len - r->pos) {
+    LEPUS_ThrowTypeError(r->ctx, "Truncated native graph at offset %u",
+                         r->pos);
+    return false;
+  }
+  memcpy(dst, r->data + r->pos, size);
+  r->pos += size;
+  return true;
+}
+
+static inline bool hako_native_read_u32(HakoNativeReader* r,
+                                        uint32_t* value) {
+  return hako_native_read_bytes(r, value, sizeof(*value));
+}
+
+// Borrows the string bytes straight from the input
+static bool hako_native_read_string(HakoNativeReader* r, const char** str,
+                                    uint32_t* len) {
+  if (!hako_native_read_u32(r, len)) {
+    return false;
+  }
+  if (*len > r->len - r->pos) {
+    LEPUS_ThrowTypeError(r->ctx, "Truncated native graph at offset %u",
+                         r->pos);
+    return false;
+  }
+  *str = (const char*)r->data + r->pos;
+  r->pos += *len;
+  return true;
+}
+
+static bool hako_native_read_key(HakoNativeReader* r, LEPUSAtom* atom) {
+  uint32_t index;
+  if (!hako_native_read_u32(r, &index)) {
+    return false;
+  }
+  if (index != HAKO_NATIVE_NEW_KEY) {
+    if (index >= r->key_count) {
+      LEPUS_ThrowTypeError(r->ctx, "Invalid native graph key index %u", index);
+      return false;
+    }
+    *atom = r->keys[index];
+    return true;
+  }
+  const char* str;
+  uint32_t len;
+  if (!hako_native_read_string(r, &str, &len)) {
+    return false;
+  }
+  if (!hako_u32_reserve(LEPUS_GetRuntime(r->ctx), &r->keys, &r->key_capacity,
+                        r->key_count + 1)) {
+    LEPUS_ThrowOutOfMemory(r->ctx);
+    return false;
+  }
+  *atom = LEPUS_NewAtomLen(r->ctx, str, len);
+  if (*atom == LEPUS_ATOM_NULL) {
+    return false;
+  }
+  r->keys[r->key_count++] = *atom;
+  return true;
+}
+
+static bool hako_native_track_object(HakoNativeReader* r, LEPUSValue obj) {
+  if (r->object_count == r->object_capacity) {
+    LEPUSRuntime* rt = LEPUS_GetRuntime(r->ctx);
+    uint32_t capacity = r->object_capacity ? r->object_capacity * 2 : 64;
+    LEPUSValue* objects = lepus_malloc_rt(rt, sizeof(LEPUSValue) * capacity,
+                                          ALLOC_TAG_WITHOUT_PTR);
+    if (!objects) {
+      LEPUS_ThrowOutOfMemory(r->ctx);
+      return false;
+    }
+    if (r->objects) {
+      memcpy(objects, r->objects, sizeof(LEPUSValue) * r->object_count);
+      lepus_free_rt(rt, r->objects);
+    }
+    r->objects = objects;
+    r->object_capacity = capacity;
+  }
+  r->objects[r->object_count++] = obj;
+  return true;
+}
+
+static LEPUSValue hako_native_read_bigint(HakoNativeReader* r) {
+  LEPUSContext* ctx = r->ctx;
+  const char* str;
+  uint32_t len;
+  if (!hako_native_read_string(r, &str, &len)) {
+    return LEPUS_EXCEPTION;
+  }
+#ifdef CONFIG_BIGNUM
+  if (LEPUS_IsUndefined(r->bigint_ctor)) {
+    LEPUSValue global = LEPUS_GetGlobalObject(ctx);
+    r->bigint_ctor = LEPUS_GetPropertyStr(ctx, global, "BigInt");
+    LEPUS_FreeValue(ctx, global);
+    if (LEPUS_IsException(r->bigint_ctor)) {
+      r->bigint_ctor = LEPUS_UNDEFINED;
+      return LEPUS_EXCEPTION;
+    }
+  }
+  LEPUSValue digits = LEPUS_NewStringLen(ctx, str, len);
+  if (LEPUS_IsException(digits)) {
+    return digits;
+  }
+  LEPUSValue result =
+      LEPUS_Call(ctx, r->bigint_ctor, LEPUS_UNDEFINED, 1, &digits);
+  LEPUS_FreeValue(ctx, digits);
+  return result;
+#else
+  return LEPUS_ThrowTypeError(ctx, "BigInt not supported");
+#endif
+}
+
+static LEPUSValue hako_native_read_container(HakoNativeReader* r, uint8_t tag,
+                                             uint32_t depth) {
+  LEPUSContext* ctx = r->ctx;
+  if (depth >= r->max_depth) {
+    return LEPUS_ThrowTypeError(
+        ctx, "Value graph exceeds the maximum depth of %u", r->max_depth);
+  }
+  uint32_t count;
+  if (!hako_native_read_u32(r, &count)) {
+    return LEPUS_EXCEPTION;
+  }
+  // Every entry takes at least one byte, so a larger count is malformed and
+  // must not drive a huge loop
+  if (count > r->len - r->pos) {
+    return LEPUS_ThrowTypeError(ctx, "Truncated native graph at offset %u",
+                                r->pos);
+  }
+  LEPUSValue obj =
+      tag == HAKO_NATIVE_ARRAY ? LEPUS_NewArray(ctx) : LEPUS_NewObject(ctx);
+  if (LEPUS_IsException(obj)) {
+    return obj;
+  }
+  if (!hako_native_track_object(r, obj)) {
+    LEPUS_FreeValue(ctx, obj);
+    return LEPUS_EXCEPTION;
+  }
+  // Records are built in stream order with shared atoms, so a run of
+  // same-shaped records follows the first one's shape transitions instead
+  // of creating new shapes
+  for (uint32_t i = 0; i < count; i++) {
+    LEPUSAtom atom = LEPUS_ATOM_NULL;
+    if (tag == HAKO_NATIVE_OBJECT && !hako_native_read_key(r, &atom)) {
+      goto fail;
+    }
+    LEPUSValue item = hako_native_read(r, depth + 1);
+    if (LEPUS_IsException(item)) {
+      goto fail;
+    }
+    int ret = tag == HAKO_NATIVE_ARRAY
+                  ? LEPUS_DefinePropertyValueUint32(ctx, obj, i, item,
+                                                    LEPUS_PROP_C_W_E)
+                  : LEPUS_DefinePropertyValue(ctx, obj, atom, item,
+                                              LEPUS_PROP_C_W_E);
+    if (ret < 0) {
+      goto fail;
+    }
+  }
+  return obj;
+
+fail:
+  LEPUS_FreeValue(ctx, obj);
+  return LEPUS_EXCEPTION;
+}
+
+static LEPUSValue hako_native_read(HakoNativeReader* r, uint32_t depth) {
+  LEPUSContext* ctx = r->ctx;
+  uint8_t tag;
+  if (!hako_native_read_bytes(r, &tag, sizeof(tag))) {
+    return LEPUS_EXCEPTION;
+  }
+  switch (tag) {
+    case HAKO_NATIVE_UNDEFINED:
+      return LEPUS_UNDEFINED;
+    case HAKO_NATIVE_NULL:
+      return LEPUS_NULL;
+    case HAKO_NATIVE_FALSE:
+    case HAKO_NATIVE_TRUE:
+      return LEPUS_NewBool(ctx, tag == HAKO_NATIVE_TRUE);
+    case HAKO_NATIVE_INT32: {
+      uint32_t num;
+      if (!hako_native_read_u32(r, &num)) {
+        return LEPUS_EXCEPTION;
+      }
+      return LEPUS_NewInt32(ctx, (int32_t)num);
+    }
+    case HAKO_NATIVE_FLOAT64: {
+      double num;
+      if (!hako_native_read_bytes(r, &num, sizeof(num))) {
+        return LEPUS_EXCEPTION;
+      }
+      return LEPUS_NewFloat64(ctx, num);
+    }
+    case HAKO_NATIVE_STRING: {
+      const char* str;
+      uint32_t len;
+      if (!hako_native_read_string(r, &str, &len)) {
+        return LEPUS_EXCEPTION;
+      }
+      return LEPUS_NewStringLen(ctx, str, len);
+    }
+    case HAKO_NATIVE_BIGINT:
+      return hako_native_read_bigint(r);
+    case HAKO_NATIVE_ARRAY:
+    case HAKO_NATIVE_OBJECT:
+      return hako_native_read_container(r, tag, depth);
+    case HAKO_NATIVE_REF: {
+      uint32_t index;
+      if (!hako_native_read_u32(r, &index)) {
+        return LEPUS_EXCEPTION;
+      }
+      if (index >= r->object_count) {
+        return LEPUS_ThrowTypeError(
+            ctx, "Invalid native graph reference %u", index);
+      }
+      return LEPUS_DupValue(ctx, r->objects[index]);
+    }
+    case HAKO_NATIVE_OPAQUE: {
+      uint32_t ptr;
+      if (!hako_native_read_u32(r, &ptr)) {
+        return LEPUS_EXCEPTION;
+      }
+      if (ptr == 0) {
+        return LEPUS_ThrowTypeError(ctx, "Invalid native graph value");
+      }
+      return LEPUS_DupValue(ctx, *(LEPUSValue*)(uintptr_t)ptr);
+    }
+    default:
+      return LEPUS_ThrowTypeError(ctx, "Invalid native graph tag %u at %u",
+                                  tag, r->pos - 1);
+  }
+}
+
+LEPUSValue* WASM_EXPORT(HAKO_FromNative)(LEPUSContext* ctx,
+                                         const uint8_t* data, uint32_t len,
+                                         uint32_t max_depth) {
+  if (data == NULL) {
+    return jsvalue_to_heap(ctx, LEPUS_ThrowTypeError(ctx, "Invalid arguments"));
+  }
+  HakoNativeReader r;
+  memset(&r, 0, sizeof(r));
+  r.ctx = ctx;
+  r.data = data;
+  r.len = len;
+  r.max_depth = max_depth ? max_depth : HAKO_NATIVE_DEFAULT_MAX_DEPTH;
+  r.bigint_ctor = LEPUS_UNDEFINED;
+
+  LEPUSValue result = LEPUS_EXCEPTION;
+  uint8_t version;
+  if (hako_native_read_bytes(&r, &version, sizeof(version))) {
+    if (version != HAKO_NATIVE_VERSION) {
+      LEPUS_ThrowTypeError(ctx, "Unsupported native graph version %u",
+                           version);
+    } else {
+      result = hako_native_read(&r, 0);
+    }
+  }
+  if (!LEPUS_IsException(result) && r.pos != r.len) {
+    LEPUS_FreeValue(ctx, result);
+    result = LEPUS_ThrowTypeError(
+        ctx, "Unexpected data after native graph at offset %u", r.pos);
+  }
+
+  LEPUSRuntime* rt = LEPUS_GetRuntime(ctx);
+  for (uint32_t i = 0; i < r.key_count; i++) {
+    LEPUS_FreeAtom(ctx, r.keys[i]);
+  }
+  lepus_free_rt(rt, r.keys);
+  lepus_free_rt(rt, r.objects);
+  LEPUS_FreeValue(ctx, r.bigint_ctor);
+  return jsvalue_to_heap(ctx, result);
+}
+
 // Module loading helpers
 
 // C -> Host Callbacks
@@ -1400,8 +4986,10 @@ LEPUSValue hako_call_function(LEPUSContext* ctx, LEPUSValueConst this_val,
   }
 
   LEPUSValue result = *result_ptr;
-
-  lepus_free(ctx, result_ptr);
+  if (!jsvalue_heap_release(LEPUS_GetRuntime(ctx), result_ptr)) {
+    // Constants are borrowed, hand back a copy the engine can own
+    return LEPUS_DupValue(ctx, result);
+  }
   return result;
 }
 
@@ -1468,10 +5056,113 @@ void WASM_EXPORT(HAKO_RuntimeEnableModuleLoader)(
   LEPUS_SetModuleLoaderFunc(rt, module_normalize, hako_load_module,
                             hako_resolve_module, hako_module_check_attributes,
                             NULL);
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (data) {
+    data->module_loader = true;
+  }
 }
 
 void WASM_EXPORT(HAKO_RuntimeDisableModuleLoader)(LEPUSRuntime* rt) {
   LEPUS_SetModuleLoaderFunc(rt, NULL, NULL, NULL, NULL, NULL);
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (data) {
+    data->module_loader = false;
+  }
+}
+
+// Registered modules need hako_load_module even when the embedder never
+// enabled a module loader of its own
+static int hako_register_module(LEPUSRuntime* rt, CString* module_name,
+                                const uint8_t* bytes, uint32_t length,
+                                bool is_bytecode) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (!data || !module_name || (!bytes && length > 0) ||
+      !hako_registry_add(rt, module_name, bytes, length, is_bytecode)) {
+    return -1;
+  }
+  if (!data->module_loader) {
+    LEPUS_SetModuleLoaderFunc(rt, NULL, hako_load_module, hako_resolve_module,
+                              hako_module_check_attributes, NULL);
+    data->module_loader = true;
+  }
+  return 0;
+}
+
+int WASM_EXPORT(HAKO_RegisterModuleBytecode)(LEPUSRuntime* rt,
+                                             CString* module_name,
+                                             const uint8_t* bytecode,
+                                             uint32_t bytecode_length) {
+  return hako_register_module(rt, module_name, bytecode, bytecode_length,
+                              true);
+}
+
+int WASM_EXPORT(HAKO_RegisterModuleSource)(LEPUSRuntime* rt,
+                                           CString* module_name,
+                                           const char* source,
+                                           uint32_t source_length) {
+  return hako_register_module(rt, module_name, (const uint8_t*)source,
+                              source_length, false);
+}
+
+void WASM_EXPORT(HAKO_UnregisterModule)(LEPUSRuntime* rt,
+                                        CString* module_name) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (!data || !module_name || data->registry.count == 0) {
+    return;
+  }
+  HakoRegisteredModule** slot = hako_registry_slot(
+      &data->registry, module_name, hako_module_name_hash(module_name));
+  if (*slot) {
+    HakoRegisteredModule* module = *slot;
+    *slot = module->next;
+    hako_registered_module_free(rt, module);
+    data->registry.count--;
+  }
+  hako_module_cache_invalidate(rt, module_name);
+}
+
+void WASM_EXPORT(HAKO_RuntimeSetModulePrefetch)(LEPUSRuntime* rt,
+                                                LEPUS_BOOL enabled) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (data) {
+    data->prefetch_modules = enabled;
+  }
+}
+
+int WASM_EXPORT(HAKO_LoadBundle)(LEPUSRuntime* rt, uint8_t* bundle_data,
+                                 uint32_t bundle_length) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (!data || !bundle_data) {
+    return -1;
+  }
+  HakoBundle* bundle =
+      lepus_malloc_rt(rt, sizeof(HakoBundle), ALLOC_TAG_WITHOUT_PTR);
+  if (!bundle) {
+    return -1;
+  }
+  bundle->data = bundle_data;
+  bundle->length = bundle_length;
+  bundle->slots = NULL;
+  if (!hako_bundle_validate(bundle) || !hako_bundle_index(rt, bundle)) {
+    // The caller keeps ownership of a rejected buffer
+    lepus_free_rt(rt, bundle);
+    return -1;
+  }
+  bundle->next = data->bundles;
+  data->bundles = bundle;
+  return (int)bundle->count;
+}
+
+void WASM_EXPORT(HAKO_InvalidateModuleCache)(LEPUSRuntime* rt,
+                                             CString* module_name) {
+  hako_module_cache_invalidate(rt, module_name);
+}
+
+void WASM_EXPORT(HAKO_UnloadBundles)(LEPUSRuntime* rt) {
+  hako_RuntimeData* data = LEPUS_GetRuntimeOpaque(rt);
+  if (data) {
+    hako_bundles_free(rt, data);
+  }
 }
 
 JSVoid* WASM_EXPORT(HAKO_BJSON_Encode)(LEPUSContext* ctx, LEPUSValueConst* val,
@@ -1789,7 +5480,9 @@ static LEPUSValue hako_class_constructor_wrapper(LEPUSContext* ctx,
   }
 
   LEPUSValue ret = *result;
-  lepus_free(ctx, result);
+  if (!jsvalue_heap_release(LEPUS_GetRuntime(ctx), result)) {
+    return LEPUS_DupValue(ctx, ret);
+  }
   return ret;
 }
 
@@ -80,6 +80,95 @@ typedef enum {
   HAKO_TYPE_FUNCTION = 7
 } HAKOTypeOf;
 
+// Shape of the characters returned by HAKO_GetStringView
+typedef struct HakoStringView {
+  uint32_t length;  // Length in characters
+  uint32_t wide;    // 1 for UTF-16 code units, 0 for Latin-1 bytes
+} HakoStringView;
+
+#define HAKO_BATCH_MAX_REGISTERS 256
+
+// Opcodes understood by HAKO_ExecBatch. Operands follow the opcode as uint32
+// words; register operands index the batch register file.
+typedef enum {
+  HAKO_BATCH_LOAD = 1,        // dst, LEPUSValueConst* (duplicated)
+  HAKO_BATCH_LOAD_STRING = 2, // dst, CString*
+  HAKO_BATCH_LOAD_INT = 3,    // dst, int32
+  HAKO_BATCH_GET = 4,         // dst, obj, key
+  HAKO_BATCH_SET = 5,         // obj, key, value
+  HAKO_BATCH_DEFINE = 6,      // obj, key, value
+  HAKO_BATCH_CALL = 7,        // dst, func, this, argc, args...
+  HAKO_BATCH_NEW = 8,         // dst, ctor, argc, args...
+  HAKO_BATCH_TYPEOF = 9,      // reg -> next output slot
+  HAKO_BATCH_FREE = 10,       // reg
+  HAKO_BATCH_EXPORT = 11      // reg -> next output slot (LEPUSValue*)
+} HAKO_BatchOp;
+
+// Entry kinds of HAKO_GetOwnPropertyNamesPacked output
+typedef enum {
+  HAKO_PACKED_KEY_INDEX = 0,   // u32 holds the array index
+  HAKO_PACKED_KEY_STRING = 1,  // u32 holds an owned atom or 0
+  HAKO_PACKED_KEY_SYMBOL = 2   // u32 always holds an owned atom
+} HAKO_PackedKeyKind;
+
+// HAKO_GetOwnPropertyNamesPacked flags
+#define HAKO_PACK_KEY_ATOMS (1 << 0)  // Include atoms for string keys
+#define HAKO_PACK_KEY_UTF8 (1 << 1)   // Append UTF-8 bytes to string keys
+
+#define HAKO_NATIVE_VERSION 1
+#define HAKO_NATIVE_DEFAULT_MAX_DEPTH 256
+#define HAKO_NATIVE_NEW_KEY UINT32_MAX
+
+// HAKO_ToNative flags
+#define HAKO_NATIVE_REJECT_CYCLES (1 << 0)
+
+// Tags of the native graph format shared by HAKO_ToNative and
+// HAKO_FromNative. A stream is a version byte followed by one value; all
+// integers are little-endian. Objects and arrays are numbered in the order
+// they appear, and object keys are numbered in the order they are first
+// written so later objects can refer back to them.
+typedef enum {
+  HAKO_NATIVE_UNDEFINED = 0,
+  HAKO_NATIVE_NULL = 1,
+  HAKO_NATIVE_FALSE = 2,
+  HAKO_NATIVE_TRUE = 3,
+  HAKO_NATIVE_INT32 = 4,    // i32
+  HAKO_NATIVE_FLOAT64 = 5,  // f64
+  HAKO_NATIVE_STRING = 6,   // u32 byte length, UTF-8 bytes
+  HAKO_NATIVE_ARRAY = 7,    // u32 count, count values
+  HAKO_NATIVE_OBJECT = 8,   // u32 count, count (key, value) pairs where key
+                            // is a u32 key index, or HAKO_NATIVE_NEW_KEY
+                            // followed by u32 byte length and UTF-8 bytes
+  HAKO_NATIVE_REF = 9,      // u32 index of an earlier object or array
+  HAKO_NATIVE_BIGINT = 10,  // u32 byte length, decimal digits
+  HAKO_NATIVE_OPAQUE = 11   // u32 LEPUSValue*; HAKO_ToNative hands it to
+                            // the caller, HAKO_FromNative duplicates it
+} HAKO_NativeTag;
+
+// Module bytecode bundle loaded by HAKO_LoadBundle; all integers are
+// little-endian u32. The header (magic, version, count) is followed by
+// count index entries of (name offset, name length, bytecode offset,
+// bytecode length), with offsets measured from the start of the bundle. Each
+// bytecode section is a module serialized by HAKO_CompileToByteCode under
+// the normalized name it is imported by.
+#define HAKO_BUNDLE_MAGIC 0x43424b48  // "HKBC"
+#define HAKO_BUNDLE_VERSION 1
+#define HAKO_BUNDLE_HEADER_SIZE 12
+#define HAKO_BUNDLE_ENTRY_SIZE 16
+
+// Source being assembled from chunks; see HAKO_EvalBufferBegin
+typedef struct HakoEvalBuffer HakoEvalBuffer;
+
+// Counters reported by HAKO_GetScriptCacheStats; sizes are in bytes
+typedef struct HakoScriptCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t evictions;
+  uint32_t entries;
+  uint32_t bytes;
+  uint32_t limit;  // 0 when the cache is disabled
+} HakoScriptCacheStats;
+
 /**
  * @brief Creates a new Hako runtime
  * @category Runtime Management
@@ -119,6 +208,43 @@ void HAKO_SetStripInfo(LEPUSRuntime* rt, int flags);
  */
 int HAKO_GetStripInfo(LEPUSRuntime* rt);
 
+/**
+ * @brief Records the runtime and context a pre-initialized build starts with
+ * @category Runtime Management
+ *
+ * Called by the pre-initialization tool before it captures linear memory.
+ * The pointers live in linear memory, so an instance of the captured module
+ * reports them from HAKO_GetPreinitializedRuntime and
+ * HAKO_GetPreinitializedContext without creating anything. Freeing the
+ * runtime or context clears the recorded pointer.
+ *
+ * @param rt Initialized runtime
+ * @param ctx Initialized template context of rt
+ * @tsparam rt JSRuntimePointer
+ * @tsparam ctx JSContextPointer
+ */
+void HAKO_SetPreinitialized(LEPUSRuntime* rt, LEPUSContext* ctx);
+
+/**
+ * @brief Gets the runtime captured in a pre-initialized build
+ * @category Runtime Management
+ *
+ * @return LEPUSRuntime* - Captured runtime, or NULL if the module was not
+ * pre-initialized
+ * @tsreturn JSRuntimePointer
+ */
+LEPUSRuntime* HAKO_GetPreinitializedRuntime();
+
+/**
+ * @brief Gets the template context captured in a pre-initialized build
+ * @category Runtime Management
+ *
+ * @return LEPUSContext* - Captured context, or NULL if the module was not
+ * pre-initialized
+ * @tsreturn JSContextPointer
+ */
+LEPUSContext* HAKO_GetPreinitializedContext();
+
 /**
  * @brief Sets memory limit for the runtime
  * @category Runtime Management
@@ -130,6 +256,45 @@ int HAKO_GetStripInfo(LEPUSRuntime* rt);
  */
 void HAKO_RuntimeSetMemoryLimit(LEPUSRuntime* rt, size_t limit);
 
+/**
+ * @brief Sets the size limit of the runtime's compiled script cache
+ * @category Runtime Management
+ *
+ * Non-module scripts passed to HAKO_Eval are cached by their source,
+ * filename, flags and the runtime strip flags, so evaluating the same script
+ * again in any context of the runtime skips parsing and compilation. Entries
+ * keep a copy of the source, which counts towards the limit. Least recently
+ * used entries are evicted once the limit is exceeded. The default is 8 MiB in
+ * builds with ENABLE_CODECACHE and 0 otherwise.
+ *
+ * @param rt Runtime to configure
+ * @param limit Cache size limit in bytes, or 0 to disable and empty the cache
+ * @tsparam rt JSRuntimePointer
+ * @tsparam limit number
+ */
+void HAKO_SetScriptCacheLimit(LEPUSRuntime* rt, uint32_t limit);
+
+/**
+ * @brief Reads the compiled script cache counters
+ * @category Runtime Management
+ *
+ * @param rt Runtime to query
+ * @param out_stats Receives a HakoScriptCacheStats (six u32 fields)
+ * @tsparam rt JSRuntimePointer
+ * @tsparam out_stats number
+ */
+void HAKO_GetScriptCacheStats(LEPUSRuntime* rt,
+                              HakoScriptCacheStats* out_stats);
+
+/**
+ * @brief Drops every entry of the compiled script cache
+ * @category Runtime Management
+ *
+ * @param rt Runtime whose cache to empty
+ * @tsparam rt JSRuntimePointer
+ */
+void HAKO_PurgeScriptCache(LEPUSRuntime* rt);
+
 /**
  * @brief Computes memory usage statistics for the runtime
  * @category Memory
@@ -222,6 +387,136 @@ void HAKO_RuntimeEnableModuleLoader(LEPUSRuntime* rt,
  */
 void HAKO_RuntimeDisableModuleLoader(LEPUSRuntime* rt);
 
+/**
+ * @brief Enables batched prefetch of module import graphs
+ * @category Module Loading
+ *
+ * When enabled, the bridge scans each module it compiles for static import
+ * specifiers and requests all of them from the host in one load_modules
+ * call, repeating for the returned sources so the graph is fetched level by
+ * level. Imports are then normalized and loaded from the prefetched results
+ * without further host calls. Imports with attributes, dynamic imports and
+ * anything the host does not return go through the regular loader, as do
+ * registered, bundled and cached modules, which are not requested.
+ *
+ * The host must provide the hako.load_modules import even when prefetch is
+ * never enabled, since the module links against it.
+ *
+ * @param rt Runtime to configure
+ * @param enabled Whether to prefetch imports
+ * @tsparam rt JSRuntimePointer
+ * @tsparam enabled LEPUS_BOOL
+ */
+void HAKO_RuntimeSetModulePrefetch(LEPUSRuntime* rt, LEPUS_BOOL enabled);
+
+/**
+ * @brief Drops compiled modules cached for every context of the runtime
+ * @category Module Loading
+ *
+ * Modules whose source the host loader returns with a version are compiled
+ * once per runtime; later contexts that import the same name and version
+ * instantiate the cached bytecode instead of compiling it again. Returning
+ * a new version also replaces the cached module.
+ *
+ * @param rt Runtime whose module cache to invalidate
+ * @param module_name Normalized module name, or NULL to drop every module
+ * @tsparam rt JSRuntimePointer
+ * @tsparam module_name CString
+ */
+void HAKO_InvalidateModuleCache(LEPUSRuntime* rt, CString* module_name);
+
+/**
+ * @brief Registers a bundle of precompiled modules with the runtime
+ * @category Module Loading
+ *
+ * The bundle's entries are indexed by name here, so a lookup costs one hash
+ * probe per loaded bundle. A module is deserialized when an import first
+ * resolves to its name, without calling the host module loader;
+ * names missing from every bundle still go to the host. The module loader
+ * must be enabled for imports to reach the bundle. Later bundles take
+ * precedence over earlier ones.
+ *
+ * @param rt Runtime to register the bundle with
+ * @param bundle_data Bundle allocated with HAKO_RuntimeMalloc; on success the
+ * runtime takes ownership and frees it with the runtime
+ * @param bundle_length Bundle size in bytes
+ * @return int - Number of modules in the bundle, or -1 if it is malformed
+ * @tsparam rt JSRuntimePointer
+ * @tsparam bundle_data number
+ * @tsparam bundle_length number
+ * @tsreturn number
+ */
+int HAKO_LoadBundle(LEPUSRuntime* rt, uint8_t* bundle_data,
+                    uint32_t bundle_length);
+
+/**
+ * @brief Frees every bundle registered with HAKO_LoadBundle
+ * @category Module Loading
+ *
+ * Modules already imported stay loaded in their contexts.
+ *
+ * @param rt Runtime whose bundles to free
+ * @tsparam rt JSRuntimePointer
+ */
+void HAKO_UnloadBundles(LEPUSRuntime* rt);
+
+/**
+ * @brief Registers a precompiled module under a name
+ * @category Module Loading
+ *
+ * Imports of the name are served from the bridge before bundles or the host
+ * module loader are consulted. A basic module loader is installed if none is
+ * enabled. Registering a name again replaces the previous module.
+ *
+ * @param rt Runtime to register the module with
+ * @param module_name Module name as it appears after normalization
+ * @param bytecode Module bytecode from HAKO_CompileToByteCode; it is copied
+ * @param bytecode_length Bytecode size in bytes
+ * @return int - 0 on success, -1 on failure
+ * @tsparam rt JSRuntimePointer
+ * @tsparam module_name CString
+ * @tsparam bytecode number
+ * @tsparam bytecode_length number
+ * @tsreturn number
+ */
+int HAKO_RegisterModuleBytecode(LEPUSRuntime* rt, CString* module_name,
+                                const uint8_t* bytecode,
+                                uint32_t bytecode_length);
+
+/**
+ * @brief Registers module source code under a name
+ * @category Module Loading
+ *
+ * Behaves like HAKO_RegisterModuleBytecode. The source is compiled the first
+ * time it is imported and the bytecode is shared by every context of the
+ * runtime.
+ *
+ * @param rt Runtime to register the module with
+ * @param module_name Module name as it appears after normalization
+ * @param source Module source code; it is copied
+ * @param source_length Source length in bytes
+ * @return int - 0 on success, -1 on failure
+ * @tsparam rt JSRuntimePointer
+ * @tsparam module_name CString
+ * @tsparam source number
+ * @tsparam source_length number
+ * @tsreturn number
+ */
+int HAKO_RegisterModuleSource(LEPUSRuntime* rt, CString* module_name,
+                              const char* source, uint32_t source_length);
+
+/**
+ * @brief Removes a module registered with HAKO_RegisterModuleBytecode or
+ * HAKO_RegisterModuleSource
+ * @category Module Loading
+ *
+ * @param rt Runtime the module is registered with
+ * @param module_name Module name
+ * @tsparam rt JSRuntimePointer
+ * @tsparam module_name CString
+ */
+void HAKO_UnregisterModule(LEPUSRuntime* rt, CString* module_name);
+
 /**
  * @brief Throws a JavaScript reference error with a message
  * @category Error Handling
@@ -301,6 +596,47 @@ void HAKO_SetVirtualStackSize(LEPUSContext* ctx, uint32_t size);
  */
 void HAKO_FreeContext(LEPUSContext* ctx);
 
+/**
+ * @brief Records the global object's properties as the state that
+ * HAKO_ResetContext returns the context to
+ * @category Context Management
+ *
+ * Call it right after HAKO_NewContext, or after a prelude that every user of
+ * the context should see. Calling it again replaces the previous baseline.
+ *
+ * @param ctx Context to record
+ * @return int - 0 on success, -1 on error (exception set)
+ * @tsparam ctx JSContextPointer
+ * @tsreturn number
+ */
+int HAKO_SaveContextBaseline(LEPUSContext* ctx);
+
+/**
+ * @brief Returns a context to the baseline recorded by
+ * HAKO_SaveContextBaseline so that it can be reused instead of freed
+ * @category Context Management
+ *
+ * Deletes global properties added since the baseline and restores baseline
+ * global properties that were reassigned, redefined or deleted. Intrinsic
+ * objects are kept as they are, including any changes made to them (for
+ * example, methods added to Array.prototype). The context data pointer is
+ * left to the embedder, which owns it and must free or replace it itself.
+ *
+ * Some state cannot be dropped from outside the engine and stays in the
+ * context: top-level let, const and class bindings of global scripts, loaded
+ * module instances and pending jobs. Global var and function declarations
+ * are non-configurable, so they cannot be deleted either; they are counted
+ * in the return value. A context that ran untrusted code should only be
+ * reused for the same tenant.
+ *
+ * @param ctx Context to reset
+ * @return int - Number of global properties that could not be removed or
+ * restored, or -1 on error (exception set, or no baseline was saved)
+ * @tsparam ctx JSContextPointer
+ * @tsreturn number
+ */
+int HAKO_ResetContext(LEPUSContext* ctx);
+
 /**
  * @brief Sets the maximum stack size for a context
  * @category Context Management
@@ -383,6 +719,110 @@ void HAKO_FreeValuePointer(LEPUSContext* ctx, LEPUSValue* value);
  */
 void HAKO_FreeValuePointerRuntime(LEPUSRuntime* rt, LEPUSValue* value);
 
+/**
+ * @brief Gets the generation-tagged handle of a value pointer
+ * @category Value Management
+ *
+ * Value pointers are slots in the runtime's handle table and are recycled once
+ * freed. The handle encodes the low 12 bits of the slot's generation, so most
+ * uses of a handle after its value was freed are detected. This is a debugging
+ * aid, not a guarantee: after 4096 reuses of a slot, a stale handle resolves
+ * to the slot's current value again.
+ *
+ * @param ctx Context the value belongs to
+ * @param value Value pointer returned by a HAKO_ function
+ * @return uint32_t - Handle for the value, or 0 if the pointer is not live
+ * @tsparam ctx JSContextPointer
+ * @tsparam value JSValueConstPointer
+ * @tsreturn number
+ */
+uint32_t HAKO_ValueToHandle(LEPUSContext* ctx, LEPUSValueConst* value);
+
+/**
+ * @brief Resolves a handle back to its value pointer
+ * @category Value Management
+ *
+ * @param ctx Context the value belongs to
+ * @param handle Handle returned by HAKO_ValueToHandle
+ * @return LEPUSValue* - Value pointer, or NULL if detected as stale
+ * @tsparam ctx JSContextPointer
+ * @tsparam handle number
+ * @tsreturn JSValuePointer
+ */
+LEPUSValue* HAKO_HandleToValue(LEPUSContext* ctx, uint32_t handle);
+
+/**
+ * @brief Frees a value by handle
+ * @category Value Management
+ *
+ * @param ctx Context the value belongs to
+ * @param handle Handle returned by HAKO_ValueToHandle
+ * @return LEPUS_BOOL - True if freed, false if detected as stale
+ * @tsparam ctx JSContextPointer
+ * @tsparam handle number
+ * @tsreturn LEPUS_BOOL
+ */
+LEPUS_BOOL HAKO_FreeHandle(LEPUSContext* ctx, uint32_t handle);
+
+/**
+ * @brief Gets the number of value pointers currently live in a runtime
+ * @category Value Management
+ *
+ * A runtime holds at most 1048574 live value pointers. Once that many are
+ * live, exports that return a new value pointer fail as if out of memory
+ * until some are freed.
+ *
+ * @param rt Runtime to inspect
+ * @return uint32_t - Number of live value slots
+ * @tsparam rt JSRuntimePointer
+ * @tsreturn number
+ */
+uint32_t HAKO_GetLiveHandleCount(LEPUSRuntime* rt);
+
+/**
+ * @brief Opens a value scope
+ * @category Value Management
+ *
+ * Every value pointer created for this context while the scope is open is
+ * recorded and freed in bulk by HAKO_PopValueScope, unless it was freed or
+ * promoted before then. Each context has its own stack of scopes; values
+ * created for other contexts are never recorded.
+ *
+ * @param ctx Context to use
+ * @return uint32_t - Scope id (its nesting depth), or 0 on failure
+ * @tsparam ctx JSContextPointer
+ * @tsreturn number
+ */
+uint32_t HAKO_PushValueScope(LEPUSContext* ctx);
+
+/**
+ * @brief Closes a value scope and frees the values recorded in it
+ * @category Value Management
+ *
+ * Scopes nested inside the given scope are closed as well.
+ *
+ * @param ctx Context to use
+ * @param scope Scope id returned by HAKO_PushValueScope
+ * @return int - Number of values freed, or -1 if the scope is not open
+ * @tsparam ctx JSContextPointer
+ * @tsparam scope number
+ * @tsreturn number
+ */
+int HAKO_PopValueScope(LEPUSContext* ctx, uint32_t scope);
+
+/**
+ * @brief Moves a value pointer out of its scope into the enclosing one
+ * @category Value Management
+ *
+ * @param ctx Context to use
+ * @param value Value pointer to promote
+ * @return LEPUS_BOOL - True if promoted, false if the value was not scoped
+ * @tsparam ctx JSContextPointer
+ * @tsparam value JSValueConstPointer
+ * @tsreturn LEPUS_BOOL
+ */
+LEPUS_BOOL HAKO_PromoteValue(LEPUSContext* ctx, LEPUSValueConst* value);
+
 /**
  * @brief Allocates memory using the context's allocator
  * @category Value Management
@@ -613,6 +1053,222 @@ LEPUS_BOOL HAKO_DefineProp(LEPUSContext* ctx, LEPUSValueConst* this_val,
                            LEPUSValueConst* set, LEPUS_BOOL configurable,
                            LEPUS_BOOL enumerable, LEPUS_BOOL has_value);
 
+/**
+ * @brief Interns a property name as an atom
+ * @category Atoms
+ *
+ * Atoms let hosts resolve the property names they use repeatedly once, and
+ * then access properties without creating a key string or hashing the name.
+ *
+ * @param ctx Context to use
+ * @param utf8 Property name as UTF-8
+ * @param len Length of the name in bytes
+ * @return LEPUSAtom - The atom (must be freed with HAKO_FreeAtom), 0 on error
+ * @tsparam ctx JSContextPointer
+ * @tsparam utf8 number
+ * @tsparam len number
+ * @tsreturn JSAtom
+ */
+LEPUSAtom HAKO_NewAtom(LEPUSContext* ctx, const char* utf8, size_t len);
+
+/**
+ * @brief Duplicates an atom reference
+ * @category Atoms
+ *
+ * @param ctx Context to use
+ * @param atom Atom to duplicate
+ * @return LEPUSAtom - The same atom with its reference count incremented
+ * @tsparam ctx JSContextPointer
+ * @tsparam atom JSAtom
+ * @tsreturn JSAtom
+ */
+LEPUSAtom HAKO_DupAtom(LEPUSContext* ctx, LEPUSAtom atom);
+
+/**
+ * @brief Frees an atom reference
+ * @category Atoms
+ *
+ * @param ctx Context to use
+ * @param atom Atom to free
+ * @tsparam ctx JSContextPointer
+ * @tsparam atom JSAtom
+ */
+void HAKO_FreeAtom(LEPUSContext* ctx, LEPUSAtom atom);
+
+/**
+ * @brief Gets a property value by atom
+ * @category Atoms
+ *
+ * @param ctx Context to use
+ * @param this_val Object to get property from
+ * @param prop_atom Property name atom
+ * @return LEPUSValue* - Property value, NULL if an exception occurred
+ * @tsparam ctx JSContextPointer
+ * @tsparam this_val JSValueConstPointer
+ * @tsparam prop_atom JSAtom
+ * @tsreturn JSValuePointer
+ */
+LEPUSValue* HAKO_GetPropAtom(LEPUSContext* ctx, LEPUSValueConst* this_val,
+                             LEPUSAtom prop_atom);
+
+/**
+ * @brief Sets a property value by atom
+ * @category Atoms
+ *
+ * @param ctx Context to use
+ * @param this_val Object to set property on
+ * @param prop_atom Property name atom
+ * @param prop_value Property value
+ * @return LEPUS_BOOL - True if successful, false if failed, -1 if exception
+ * @tsparam ctx JSContextPointer
+ * @tsparam this_val JSValueConstPointer
+ * @tsparam prop_atom JSAtom
+ * @tsparam prop_value JSValueConstPointer
+ * @tsreturn LEPUS_BOOL
+ */
+LEPUS_BOOL HAKO_SetPropAtom(LEPUSContext* ctx, LEPUSValueConst* this_val,
+                            LEPUSAtom prop_atom, LEPUSValueConst* prop_value);
+
+/**
+ * @brief Defines a property with custom attributes by atom
+ * @category Atoms
+ *
+ * @param ctx Context to use
+ * @param this_val Object to define property on
+ * @param prop_atom Property name atom
+ * @param prop_value Property value
+ * @param get Getter function or undefined
+ * @param set Setter function or undefined
+ * @param configurable Whether property is configurable
+ * @param enumerable Whether property is enumerable
+ * @param has_value Whether property has a value
+ * @return LEPUS_BOOL - True if successful, false otherwise, -1 if exception
+ * @tsparam ctx JSContextPointer
+ * @tsparam this_val JSValueConstPointer
+ * @tsparam prop_atom JSAtom
+ * @tsparam prop_value JSValueConstPointer
+ * @tsparam get JSValueConstPointer
+ * @tsparam set JSValueConstPointer
+ * @tsparam configurable LEPUS_BOOL
+ * @tsparam enumerable LEPUS_BOOL
+ * @tsparam has_value LEPUS_BOOL
+ * @tsreturn LEPUS_BOOL
+ */
+LEPUS_BOOL HAKO_DefinePropAtom(LEPUSContext* ctx, LEPUSValueConst* this_val,
+                               LEPUSAtom prop_atom,
+                               LEPUSValueConst* prop_value,
+                               LEPUSValueConst* get, LEPUSValueConst* set,
+                               LEPUS_BOOL configurable, LEPUS_BOOL enumerable,
+                               LEPUS_BOOL has_value);
+
+/**
+ * @brief Serializes a value graph into the native graph format
+ * @category Value Operations
+ *
+ * Walks arrays and plain objects (own enumerable string keys) inside wasm and
+ * writes numbers, strings, booleans, null, undefined and BigInts as data.
+ * Repeated objects are written as back-references. Functions, symbols and
+ * other values are written as HAKO_NATIVE_OPAQUE value pointers that the
+ * caller owns.
+ *
+ * @param ctx Context to use
+ * @param value Value to serialize
+ * @param max_depth Maximum nesting depth, 0 for HAKO_NATIVE_DEFAULT_MAX_DEPTH
+ * @param max_bytes Maximum output size in bytes, 0 for no limit
+ * @param flags HAKO_NATIVE_* flags
+ * @param out_len Pointer to store the output length in bytes
+ * @return uint8_t* - Buffer to free with HAKO_Free, NULL on exception
+ * @tsparam ctx JSContextPointer
+ * @tsparam value JSValueConstPointer
+ * @tsparam max_depth number
+ * @tsparam max_bytes number
+ * @tsparam flags number
+ * @tsparam out_len number
+ * @tsreturn number
+ */
+uint8_t* HAKO_ToNative(LEPUSContext* ctx, LEPUSValueConst* value,
+                       uint32_t max_depth, uint32_t max_bytes, uint32_t flags,
+                       uint32_t* out_len);
+
+/**
+ * @brief Builds a value graph from the native graph format
+ * @category Value Operations
+ *
+ * Decodes a whole host-encoded graph in one call. Properties are defined in
+ * stream order as own enumerable data properties, back-references resolve to
+ * the same object, and HAKO_NATIVE_OPAQUE pointers are duplicated, so the
+ * caller keeps ownership of them.
+ *
+ * @param ctx Context to use
+ * @param data Encoded graph
+ * @param len Length of the encoded graph in bytes
+ * @param max_depth Maximum nesting depth, 0 for HAKO_NATIVE_DEFAULT_MAX_DEPTH
+ * @return LEPUSValue* - Pointer to the decoded value, or exception if failed
+ * @tsparam ctx JSContextPointer
+ * @tsparam data number
+ * @tsparam len number
+ * @tsparam max_depth number
+ * @tsreturn JSValuePointer
+ */
+LEPUSValue* HAKO_FromNative(LEPUSContext* ctx, const uint8_t* data,
+                            uint32_t len, uint32_t max_depth);
+
+/**
+ * @brief Gets several property values in one call
+ * @category Atoms
+ *
+ * Every slot is read even if an earlier one throws. A slot whose getter threw
+ * has its status set to 1 and receives the thrown value instead of a result.
+ *
+ * @param ctx Context to use
+ * @param this_val Object to get properties from
+ * @param atoms Array of count property name atoms
+ * @param count Number of properties
+ * @param out_values Output array of count value pointers (must be freed)
+ * @param out_status Output array of count bytes, 1 where the slot threw
+ * @return int - Number of slots that threw
+ * @tsparam ctx JSContextPointer
+ * @tsparam this_val JSValueConstPointer
+ * @tsparam atoms number
+ * @tsparam count number
+ * @tsparam out_values number
+ * @tsparam out_status number
+ * @tsreturn number
+ */
+int HAKO_GetProps(LEPUSContext* ctx, LEPUSValueConst* this_val,
+                  const LEPUSAtom* atoms, uint32_t count,
+                  LEPUSValue** out_values, uint8_t* out_status);
+
+/**
+ * @brief Sets several property values in one call
+ * @category Atoms
+ *
+ * Every slot is written even if an earlier one throws. A slot whose setter
+ * threw has its status set to 1, and its thrown value is stored in out_errors
+ * when provided.
+ *
+ * @param ctx Context to use
+ * @param this_val Object to set properties on
+ * @param atoms Array of count property name atoms
+ * @param count Number of properties
+ * @param values Contiguous array of count LEPUSValues, duplicated
+ * @param out_status Output array of count bytes, 1 where the slot threw
+ * @param out_errors Optional output array of count error pointers, or NULL
+ * @return int - Number of slots that threw
+ * @tsparam ctx JSContextPointer
+ * @tsparam this_val JSValueConstPointer
+ * @tsparam atoms number
+ * @tsparam count number
+ * @tsparam values number
+ * @tsparam out_status number
+ * @tsparam out_errors number
+ * @tsreturn number
+ */
+int HAKO_SetProps(LEPUSContext* ctx, LEPUSValueConst* this_val,
+                  const LEPUSAtom* atoms, uint32_t count,
+                  LEPUSValueConst* values, uint8_t* out_status,
+                  LEPUSValue** out_errors);
+
 /**
  * @brief Gets all own property names of an object
  * @category Value Operations
@@ -634,6 +1290,34 @@ LEPUSValue* HAKO_GetOwnPropertyNames(LEPUSContext* ctx, LEPUSValue*** out_ptrs,
                                      uint32_t* out_len, LEPUSValueConst* obj,
                                      int flags);
 
+/**
+ * @brief Gets own property names of an object as one packed buffer
+ * @category Value Operations
+ *
+ * The buffer starts with a u32 entry count. Each entry is a u8
+ * HAKO_PackedKeyKind and a u32 index or atom, followed for string keys by a
+ * u32 byte length and UTF-8 bytes when HAKO_PACK_KEY_UTF8 is set. Integer
+ * keys are always reported as HAKO_PACKED_KEY_INDEX. Atoms in the buffer are
+ * owned by the caller and must be released with HAKO_FreeAtom.
+ *
+ * @param ctx Context to use
+ * @param obj Object to get property names from
+ * @param flags Property name flags, as for HAKO_GetOwnPropertyNames
+ * @param pack_flags HAKO_PACK_KEY_* flags
+ * @param out_len Pointer to store the buffer length in bytes
+ * @return uint8_t* - Buffer to free with HAKO_Free, NULL on exception
+ * @tsparam ctx JSContextPointer
+ * @tsparam obj JSValueConstPointer
+ * @tsparam flags number
+ * @tsparam pack_flags number
+ * @tsparam out_len number
+ * @tsreturn number
+ */
+uint8_t* HAKO_GetOwnPropertyNamesPacked(LEPUSContext* ctx,
+                                        LEPUSValueConst* obj, int flags,
+                                        uint32_t pack_flags,
+                                        uint32_t* out_len);
+
 /**
  * @brief Gets the global object
  * @category Value Operations
@@ -687,82 +1371,215 @@ LEPUSValue* HAKO_NewFloat64(LEPUSContext* ctx, double num);
  * @tsparam high number
  * @tsreturn JSValuePointer
  */
-LEPUSValue* HAKO_NewBigInt(LEPUSContext* ctx, int32_t low, int32_t high);
+LEPUSValue* HAKO_NewBigInt(LEPUSContext* ctx, int32_t low, int32_t high);
+/**
+ * @brief Creates a new BigUInt number
+ * @category Value Creation
+ *
+ * @param ctx Context to create in
+ * @param low Low 32 bits of the number
+ * @param high High 32 bits of the number
+ * @return LEPUSValue* - New BigUInt
+ * @tsparam ctx JSContextPointer
+ * @tsparam low number
+ * @tsparam high number
+ * @tsreturn JSValuePointer
+ */
+LEPUSValue* HAKO_NewBigUInt(LEPUSContext* ctx, uint32_t low, uint32_t high);
+
+/**
+ * @brief Sets the garbage collection threshold
+ * @category Memory Management
+ *
+ * @param ctx Context to set the threshold for
+ * @param threshold Threshold in bytes
+ * @tsparam ctx JSContextPointer
+ * @tsparam threshold number
+ */
+void HAKO_SetGCThreshold(LEPUSContext* ctx, int64_t threshold);
+
+/**
+ * @brief Checks if the context is in garbage collection mode
+ * @category Memory Management
+ *
+ * @param ctx Context to check
+ * @return LEPUS_BOOL - True if in GC mode, false otherwise
+ * @tsparam ctx JSContextPointer
+ * @tsreturn LEPUS_BOOL
+ */
+LEPUS_BOOL HAKO_IsGCMode(LEPUSContext* ctx);
+
+/**
+ * @brief Gets the floating point value of a number
+ * @category Value Operations
+ *
+ * @param ctx Context to use
+ * @param value Value to convert
+ * @return double - Number value
+ * @tsparam ctx JSContextPointer
+ * @tsparam value JSValueConstPointer
+ * @tsreturn number
+ */
+double HAKO_GetFloat64(LEPUSContext* ctx, LEPUSValueConst* value);
+
+/**
+ * @brief Creates a new string
+ * @category Value Creation
+ *
+ * @param ctx Context to create in
+ * @param string String content
+ * @return LEPUSValue* - New string
+ * @tsparam ctx JSContextPointer
+ * @tsparam string CString
+ * @tsreturn JSValuePointer
+ */
+LEPUSValue* HAKO_NewString(LEPUSContext* ctx, BorrowedHeapChar* string);
+
+/**
+ * @brief Gets the C string representation of a value
+ * @category Value Operations
+ *
+ * @param ctx Context to use
+ * @param value Value to convert
+ * @return JSBorrowedChar* - String representation
+ * @tsparam ctx JSContextPointer
+ * @tsparam value JSValueConstPointer
+ * @tsreturn CString
+ */
+JSBorrowedChar* HAKO_ToCString(LEPUSContext* ctx, LEPUSValueConst* value);
+
+/**
+ * @brief Creates a new string from UTF-8 with an explicit length
+ * @category Value Creation
+ *
+ * Unlike HAKO_NewString the input does not need a null terminator and may
+ * contain embedded nulls.
+ *
+ * @param ctx Context to create in
+ * @param utf8 UTF-8 bytes
+ * @param len Length in bytes
+ * @return LEPUSValue* - New string, or exception if failed
+ * @tsparam ctx JSContextPointer
+ * @tsparam utf8 number
+ * @tsparam len number
+ * @tsreturn JSValuePointer
+ */
+LEPUSValue* HAKO_NewStringLen(LEPUSContext* ctx, const char* utf8,
+                              uint32_t len);
+
 /**
- * @brief Creates a new BigUInt number
+ * @brief Creates a new string from Latin-1 bytes
  * @category Value Creation
  *
  * @param ctx Context to create in
- * @param low Low 32 bits of the number
- * @param high High 32 bits of the number
- * @return LEPUSValue* - New BigUInt
+ * @param latin1 Latin-1 (ISO-8859-1) bytes
+ * @param len Length in bytes
+ * @return LEPUSValue* - New string, or exception if failed
  * @tsparam ctx JSContextPointer
- * @tsparam low number
- * @tsparam high number
+ * @tsparam latin1 number
+ * @tsparam len number
  * @tsreturn JSValuePointer
  */
-LEPUSValue* HAKO_NewBigUInt(LEPUSContext* ctx, uint32_t low, uint32_t high);
+LEPUSValue* HAKO_NewStringLatin1(LEPUSContext* ctx, const uint8_t* latin1,
+                                 uint32_t len);
 
 /**
- * @brief Sets the garbage collection threshold
- * @category Memory Management
+ * @brief Creates a new string from UTF-16 code units
+ * @category Value Creation
  *
- * @param ctx Context to set the threshold for
- * @param threshold Threshold in bytes
+ * Unpaired surrogates are preserved.
+ *
+ * @param ctx Context to create in
+ * @param utf16 Little-endian UTF-16 code units
+ * @param len Length in code units
+ * @return LEPUSValue* - New string, or exception if failed
  * @tsparam ctx JSContextPointer
- * @tsparam threshold number
+ * @tsparam utf16 number
+ * @tsparam len number
+ * @tsreturn JSValuePointer
  */
-void HAKO_SetGCThreshold(LEPUSContext* ctx, int64_t threshold);
+LEPUSValue* HAKO_NewStringUTF16(LEPUSContext* ctx, const uint16_t* utf16,
+                                uint32_t len);
 
 /**
- * @brief Checks if the context is in garbage collection mode
- * @category Memory Management
+ * @brief Gets the characters of a string value without copying them
+ * @category Value Operations
  *
- * @param ctx Context to check
- * @return LEPUS_BOOL - True if in GC mode, false otherwise
+ * Points at the string's own storage: Latin-1 bytes, or UTF-16 code units
+ * when view->wide is set. A rope is flattened first and the value is
+ * replaced with the flat string, so the characters stay valid as long as
+ * the value is alive. Nothing needs to be freed.
+ *
+ * @param ctx Context to use
+ * @param value String value to view
+ * @param out_view Receives the length and character width
+ * @return const void* - Characters, NULL for non-strings or on exception
  * @tsparam ctx JSContextPointer
- * @tsreturn LEPUS_BOOL
+ * @tsparam value JSValueConstPointer
+ * @tsparam out_view number
+ * @tsreturn number
  */
-LEPUS_BOOL HAKO_IsGCMode(LEPUSContext* ctx);
+const void* HAKO_GetStringView(LEPUSContext* ctx, LEPUSValue* value,
+                               HakoStringView* out_view);
 
 /**
- * @brief Gets the floating point value of a number
+ * @brief Writes the UTF-8 representation of a value into a buffer
  * @category Value Operations
  *
+ * Writes at most capacity bytes without a null terminator. Pass a capacity
+ * of 0 to query the required length.
+ *
  * @param ctx Context to use
  * @param value Value to convert
- * @return double - Number value
+ * @param buf Destination buffer, may be NULL when capacity is 0
+ * @param capacity Size of the buffer in bytes
+ * @return int32_t - Required length in bytes, -1 on exception
  * @tsparam ctx JSContextPointer
  * @tsparam value JSValueConstPointer
+ * @tsparam buf number
+ * @tsparam capacity number
  * @tsreturn number
  */
-double HAKO_GetFloat64(LEPUSContext* ctx, LEPUSValueConst* value);
+int32_t HAKO_GetStringUTF8(LEPUSContext* ctx, LEPUSValueConst* value,
+                           char* buf, uint32_t capacity);
 
 /**
- * @brief Creates a new string
- * @category Value Creation
+ * @brief Writes the Latin-1 representation of a value into a buffer
+ * @category Value Operations
  *
- * @param ctx Context to create in
- * @param string String content
- * @return LEPUSValue* - New string
+ * Throws if the string contains characters above U+00FF.
+ *
+ * @param ctx Context to use
+ * @param value Value to convert
+ * @param buf Destination buffer, may be NULL when capacity is 0
+ * @param capacity Size of the buffer in bytes
+ * @return int32_t - Required length in bytes, -1 on exception
  * @tsparam ctx JSContextPointer
- * @tsparam string CString
- * @tsreturn JSValuePointer
+ * @tsparam value JSValueConstPointer
+ * @tsparam buf number
+ * @tsparam capacity number
+ * @tsreturn number
  */
-LEPUSValue* HAKO_NewString(LEPUSContext* ctx, BorrowedHeapChar* string);
+int32_t HAKO_GetStringLatin1(LEPUSContext* ctx, LEPUSValueConst* value,
+                             uint8_t* buf, uint32_t capacity);
 
 /**
- * @brief Gets the C string representation of a value
+ * @brief Writes the UTF-16 representation of a value into a buffer
  * @category Value Operations
  *
  * @param ctx Context to use
  * @param value Value to convert
- * @return JSBorrowedChar* - String representation
+ * @param buf Destination buffer, may be NULL when capacity is 0
+ * @param capacity Size of the buffer in code units
+ * @return int32_t - Required length in code units, -1 on exception
  * @tsparam ctx JSContextPointer
  * @tsparam value JSValueConstPointer
- * @tsreturn CString
+ * @tsparam buf number
+ * @tsparam capacity number
+ * @tsreturn number
  */
-JSBorrowedChar* HAKO_ToCString(LEPUSContext* ctx, LEPUSValueConst* value);
+int32_t HAKO_GetStringUTF16(LEPUSContext* ctx, LEPUSValueConst* value,
+                            uint16_t* buf, uint32_t capacity);
 
 /**
  * @brief Creates a new symbol
@@ -960,6 +1777,114 @@ LEPUSValue* HAKO_Call(LEPUSContext* ctx, LEPUSValueConst* func_obj,
                       LEPUSValueConst* this_obj, int argc,
                       LEPUSValueConst** argv_ptrs);
 
+/**
+ * @brief Gets the context scratch argv buffer
+ * @category Value Operations
+ *
+ * The buffer holds raw LEPUSValues and is owned by the context. Fill it and
+ * pass a NULL argv to HAKO_CallArgv, HAKO_CallConstructorArgv or
+ * HAKO_InvokeArgv to call without allocating. The pointer may change when a
+ * larger buffer is requested, and is freed with the context. The buffer holds
+ * at most 1024 arguments; pass an explicit argv for longer calls.
+ *
+ * @param ctx Context to use
+ * @param argc Number of arguments the buffer must hold
+ * @return LEPUSValue* - Scratch buffer, or NULL if it is not available
+ * @tsparam ctx JSContextPointer
+ * @tsparam argc number
+ * @tsreturn number
+ */
+LEPUSValue* HAKO_GetScratchArgv(LEPUSContext* ctx, uint32_t argc);
+
+/**
+ * @brief Calls a function with a contiguous argument array
+ * @category Value Operations
+ *
+ * @param ctx Context to use
+ * @param func_obj Function to call
+ * @param this_obj This value
+ * @param argc Number of arguments
+ * @param argv Array of argc LEPUSValues, or NULL to use the scratch argv
+ * @return LEPUSValue* - Function result
+ * @tsparam ctx JSContextPointer
+ * @tsparam func_obj JSValueConstPointer
+ * @tsparam this_obj JSValueConstPointer
+ * @tsparam argc number
+ * @tsparam argv number
+ * @tsreturn JSValuePointer
+ */
+LEPUSValue* HAKO_CallArgv(LEPUSContext* ctx, LEPUSValueConst* func_obj,
+                          LEPUSValueConst* this_obj, int argc,
+                          LEPUSValueConst* argv);
+
+/**
+ * @brief Calls a constructor with a contiguous argument array
+ * @category Value Operations
+ *
+ * @param ctx Context to use
+ * @param func_obj Constructor to call
+ * @param argc Number of arguments
+ * @param argv Array of argc LEPUSValues, or NULL to use the scratch argv
+ * @return LEPUSValue* - Constructed object
+ * @tsparam ctx JSContextPointer
+ * @tsparam func_obj JSValueConstPointer
+ * @tsparam argc number
+ * @tsparam argv number
+ * @tsreturn JSValuePointer
+ */
+LEPUSValue* HAKO_CallConstructorArgv(LEPUSContext* ctx,
+                                     LEPUSValueConst* func_obj, int argc,
+                                     LEPUSValueConst* argv);
+
+/**
+ * @brief Invokes a method by atom with a contiguous argument array
+ * @category Value Operations
+ *
+ * @param ctx Context to use
+ * @param this_obj Object to invoke the method on
+ * @param atom Method name atom
+ * @param argc Number of arguments
+ * @param argv Array of argc LEPUSValues, or NULL to use the scratch argv
+ * @return LEPUSValue* - Method result
+ * @tsparam ctx JSContextPointer
+ * @tsparam this_obj JSValueConstPointer
+ * @tsparam atom JSAtom
+ * @tsparam argc number
+ * @tsparam argv number
+ * @tsreturn JSValuePointer
+ */
+LEPUSValue* HAKO_InvokeArgv(LEPUSContext* ctx, LEPUSValueConst* this_obj,
+                            LEPUSAtom atom, int argc, LEPUSValueConst* argv);
+
+/**
+ * @brief Executes a stream of batched value operations
+ * @category Value Operations
+ *
+ * Runs a sequence of HAKO_BatchOp instructions against a private register
+ * file, so a chain of property accesses and calls costs a single boundary
+ * crossing. Execution stops at the first exception. TYPEOF and EXPORT write
+ * into consecutive output slots; exported values are owned by the caller and
+ * remain valid even when a later instruction fails.
+ *
+ * @param ctx Context to use
+ * @param ops Instruction stream
+ * @param ops_len Number of uint32 words in the stream
+ * @param register_count Number of registers (max HAKO_BATCH_MAX_REGISTERS)
+ * @param out Output buffer for TYPEOF and EXPORT results
+ * @param out_len Number of uint32 slots in the output buffer
+ * @return LEPUSValue* - Exception if error occurred, NULL otherwise
+ * @tsparam ctx JSContextPointer
+ * @tsparam ops number
+ * @tsparam ops_len number
+ * @tsparam register_count number
+ * @tsparam out number
+ * @tsparam out_len number
+ * @tsreturn JSValuePointer
+ */
+LEPUSValue* HAKO_ExecBatch(LEPUSContext* ctx, const uint32_t* ops,
+                           uint32_t ops_len, uint32_t register_count,
+                           uint32_t* out, uint32_t out_len);
+
 /**
  * @brief Gets a JavaScript value from an argv array
  * @category Value Operations
@@ -997,6 +1922,120 @@ LEPUSValue* HAKO_Eval(LEPUSContext* ctx, BorrowedHeapChar* js_code,
                       size_t js_code_length, BorrowedHeapChar* filename,
                       LEPUS_BOOL detect_module, EvalFlags eval_flags);
 
+/**
+ * @brief Compiles a script once for repeated runs with HAKO_RunPrepared
+ * @category Eval
+ *
+ * The result is a handle to the compiled, unevaluated script; free it with
+ * HAKO_FreeValuePointer. Modules are rejected since they evaluate only once.
+ *
+ * @param ctx Context to compile in
+ * @param js_code Script source
+ * @param js_code_length Source length in bytes
+ * @param filename Filename for error reporting
+ * @param eval_flags Evaluation flags (LEPUS_EVAL_FLAG_STRICT, etc.)
+ * @return LEPUSValue* - Prepared script, or an exception on syntax errors
+ * @tsparam ctx JSContextPointer
+ * @tsparam js_code CString
+ * @tsparam js_code_length number
+ * @tsparam filename CString
+ * @tsparam eval_flags number
+ * @tsreturn JSValuePointer
+ */
+LEPUSValue* HAKO_PrepareScript(LEPUSContext* ctx, BorrowedHeapChar* js_code,
+                               size_t js_code_length,
+                               BorrowedHeapChar* filename,
+                               EvalFlags eval_flags);
+
+/**
+ * @brief Runs a script prepared with HAKO_PrepareScript
+ * @category Eval
+ *
+ * Each run executes the compiled bytecode without parsing or
+ * deserialization. Run it in the context it was prepared in.
+ *
+ * @param ctx Context to run in
+ * @param prepared Prepared script handle
+ * @param this_obj Value of `this` for the script, or NULL for the global
+ * object
+ * @return LEPUSValue* - Completion value of the script
+ * @tsparam ctx JSContextPointer
+ * @tsparam prepared JSValueConstPointer
+ * @tsparam this_obj JSValueConstPointer
+ * @tsreturn JSValuePointer
+ */
+LEPUSValue* HAKO_RunPrepared(LEPUSContext* ctx, LEPUSValueConst* prepared,
+                             LEPUSValueConst* this_obj);
+
+/**
+ * @brief Starts buffering a source that arrives in chunks for one eval
+ * @category Eval
+ *
+ * This is not a streaming compiler. Chunks passed to HAKO_EvalBufferAppend
+ * are copied into a single bridge-owned buffer, and nothing is parsed until
+ * HAKO_EvalBufferEnd runs a normal eval over the whole source. Compilation
+ * therefore does not overlap with reading the source, and peak memory still
+ * holds the complete source. What it saves is joining the chunks into one
+ * host string and copying that across, and the chunks are hashed for the
+ * script cache as they arrive. With an exact size hint the buffer is
+ * allocated once.
+ *
+ * @param ctx Context the source will be evaluated in
+ * @param size_hint Expected source size in bytes, or 0 if unknown
+ * @return HakoEvalBuffer* - Buffer to append to, NULL on allocation failure
+ * @tsparam ctx JSContextPointer
+ * @tsparam size_hint number
+ * @tsreturn number
+ */
+HakoEvalBuffer* HAKO_EvalBufferBegin(LEPUSContext* ctx, size_t size_hint);
+
+/**
+ * @brief Appends a chunk of UTF-8 source to an eval buffer
+ * @category Eval
+ *
+ * @param buffer Buffer from HAKO_EvalBufferBegin
+ * @param chunk Chunk bytes; a multi-byte character may span two chunks
+ * @param chunk_length Chunk size in bytes
+ * @return int - 0 on success, -1 on failure
+ * @tsparam buffer number
+ * @tsparam chunk number
+ * @tsparam chunk_length number
+ * @tsreturn number
+ */
+int HAKO_EvalBufferAppend(HakoEvalBuffer* buffer, BorrowedHeapChar* chunk,
+                          size_t chunk_length);
+
+/**
+ * @brief Evaluates the source held by an eval buffer and frees the buffer
+ * @category Eval
+ *
+ * Behaves like HAKO_Eval on the whole source, including
+ * LEPUS_EVAL_FLAG_COMPILE_ONLY.
+ *
+ * @param buffer Buffer from HAKO_EvalBufferBegin
+ * @param filename Filename for error reporting
+ * @param detect_module Whether to auto-detect module code
+ * @param eval_flags Evaluation flags
+ * @return LEPUSValue* - Evaluation result, or NULL if buffer is NULL
+ * @tsparam buffer number
+ * @tsparam filename CString
+ * @tsparam detect_module LEPUS_BOOL
+ * @tsparam eval_flags number
+ * @tsreturn JSValuePointer
+ */
+LEPUSValue* HAKO_EvalBufferEnd(HakoEvalBuffer* buffer,
+                               BorrowedHeapChar* filename,
+                               LEPUS_BOOL detect_module, EvalFlags eval_flags);
+
+/**
+ * @brief Frees an eval buffer without evaluating it
+ * @category Eval
+ *
+ * @param buffer Buffer from HAKO_EvalBufferBegin
+ * @tsparam buffer number
+ */
+void HAKO_EvalBufferAbort(HakoEvalBuffer* buffer);
+
 /**
  * @brief Creates a new promise capability
  * @category Promise
@@ -1518,6 +2557,164 @@ LEPUSValue* HAKO_GetModulePrivateValue(LEPUSContext* ctx,
  */
 LEPUS_BOOL HAKO_IsNull(LEPUSValueConst* value);
 
+/**
+ * @brief Reads the raw NaN-boxed value stored behind a value pointer
+ * @category Raw Values
+ *
+ * Raw values are passed by value as a single 64-bit word instead of through
+ * a heap allocated LEPUSValue*. They are never owned by the host: primitives
+ * need no ownership and anything else is borrowed from its value pointer.
+ *
+ * @param value Value pointer to read
+ * @return LEPUSValue - Borrowed raw value, valid while the pointer is alive
+ * @tsparam value JSValueConstPointer
+ * @tsreturn JSValueRaw
+ */
+LEPUSValue HAKO_ValueToRaw(LEPUSValueConst* value);
+
+/**
+ * @brief Boxes a raw value into a new value pointer
+ * @category Raw Values
+ *
+ * @param ctx Context to use
+ * @param value Raw value, duplicated into the new pointer
+ * @return LEPUSValue* - Pointer to the boxed value
+ * @tsparam ctx JSContextPointer
+ * @tsparam value JSValueRaw
+ * @tsreturn JSValuePointer
+ */
+LEPUSValue* HAKO_RawToValue(LEPUSContext* ctx, LEPUSValueConst value);
+
+/**
+ * @brief Gets the raw undefined value
+ * @category Raw Values
+ *
+ * @return LEPUSValue - Raw undefined
+ * @tsreturn JSValueRaw
+ */
+LEPUSValue HAKO_GetUndefinedRaw();
+
+/**
+ * @brief Gets the raw null value
+ * @category Raw Values
+ *
+ * @return LEPUSValue - Raw null
+ * @tsreturn JSValueRaw
+ */
+LEPUSValue HAKO_GetNullRaw();
+
+/**
+ * @brief Creates a raw boolean value
+ * @category Raw Values
+ *
+ * @param ctx Context to use
+ * @param value Boolean value (0 or 1)
+ * @return LEPUSValue - Raw boolean
+ * @tsparam ctx JSContextPointer
+ * @tsparam value number
+ * @tsreturn JSValueRaw
+ */
+LEPUSValue HAKO_NewBoolRaw(LEPUSContext* ctx, int value);
+
+/**
+ * @brief Creates a raw number value
+ * @category Raw Values
+ *
+ * @param ctx Context to use
+ * @param num Number value
+ * @return LEPUSValue - Raw number
+ * @tsparam ctx JSContextPointer
+ * @tsparam num number
+ * @tsreturn JSValueRaw
+ */
+LEPUSValue HAKO_NewFloat64Raw(LEPUSContext* ctx, double num);
+
+/**
+ * @brief Converts a raw value to a double
+ * @category Raw Values
+ *
+ * @param ctx Context to use
+ * @param value Raw value to convert
+ * @return double - Number value, NaN if the conversion failed
+ * @tsparam ctx JSContextPointer
+ * @tsparam value JSValueRaw
+ * @tsreturn number
+ */
+double HAKO_GetFloat64Raw(LEPUSContext* ctx, LEPUSValueConst value);
+
+/**
+ * @brief Gets the type of a raw value
+ * @category Raw Values
+ *
+ * @param ctx Context to use
+ * @param value Raw value to check
+ * @return HAKOTypeOf - Type identifier
+ * @tsparam ctx JSContextPointer
+ * @tsparam value JSValueRaw
+ * @tsreturn HAKOTypeOf
+ */
+HAKOTypeOf HAKO_TypeOfRaw(LEPUSContext* ctx, LEPUSValueConst value);
+
+/**
+ * @brief Checks if a raw value is null
+ * @category Raw Values
+ *
+ * @param value Raw value to check
+ * @return LEPUS_BOOL - True if value is null
+ * @tsparam value JSValueRaw
+ * @tsreturn LEPUS_BOOL
+ */
+LEPUS_BOOL HAKO_IsNullRaw(LEPUSValueConst value);
+
+/**
+ * @brief Checks if a raw value is undefined
+ * @category Raw Values
+ *
+ * @param value Raw value to check
+ * @return LEPUS_BOOL - True if value is undefined
+ * @tsparam value JSValueRaw
+ * @tsreturn LEPUS_BOOL
+ */
+LEPUS_BOOL HAKO_IsUndefinedRaw(LEPUSValueConst value);
+
+/**
+ * @brief Sets a property to a raw value
+ * @category Raw Values
+ *
+ * @param ctx Context to use
+ * @param this_val Object to set property on
+ * @param prop_name Property name
+ * @param prop_value Raw property value, duplicated
+ * @return LEPUS_BOOL - True if successful, false if failed, -1 if exception
+ * @tsparam ctx JSContextPointer
+ * @tsparam this_val JSValueConstPointer
+ * @tsparam prop_name JSValueConstPointer
+ * @tsparam prop_value JSValueRaw
+ * @tsreturn LEPUS_BOOL
+ */
+LEPUS_BOOL HAKO_SetPropRaw(LEPUSContext* ctx, LEPUSValueConst* this_val,
+                           LEPUSValueConst* prop_name,
+                           LEPUSValueConst prop_value);
+
+/**
+ * @brief Sets a property to a raw value by atom
+ * @category Raw Values
+ *
+ * @param ctx Context to use
+ * @param this_val Object to set property on
+ * @param prop_atom Property name atom
+ * @param prop_value Raw property value, duplicated
+ * @return LEPUS_BOOL - True if successful, false if failed, -1 if exception
+ * @tsparam ctx JSContextPointer
+ * @tsparam this_val JSValueConstPointer
+ * @tsparam prop_atom JSAtom
+ * @tsparam prop_value JSValueRaw
+ * @tsreturn LEPUS_BOOL
+ */
+LEPUS_BOOL HAKO_SetPropAtomRaw(LEPUSContext* ctx, LEPUSValueConst* this_val,
+                               LEPUSAtom prop_atom,
+                               LEPUSValueConst prop_value);
+
 #ifdef HAKO_DEBUG_MODE
 #define HAKO_LOG(msg) hako_log(msg)
 #else
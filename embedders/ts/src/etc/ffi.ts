@@ -14,10 +14,12 @@
 import type {
     CString,
     HAKOTypeOf,
+    JSAtom,
     JSContextPointer,
     JSRuntimePointer,
     JSValueConstPointer,
     JSValuePointer,
+    JSValueRaw,
     LEPUS_BOOL,
     LEPUSModuleDef,
 } from './types';
@@ -45,6 +47,91 @@ export interface HakoExports {
      */
     HAKO_RuntimeDumpMemoryUsage(rt: JSRuntimePointer): CString;
 
+    // Atoms
+    /**
+     * Defines a property with custom attributes by atom
+     *
+     * @param ctx Context to use
+     * @param this_val Object to define property on
+     * @param prop_atom Property name atom
+     * @param prop_value Property value
+     * @param get Getter function or undefined
+     * @param set Setter function or undefined
+     * @param configurable Whether property is configurable
+     * @param enumerable Whether property is enumerable
+     * @param has_value Whether property has a value
+     * @returns LEPUS_BOOL - True if successful, false otherwise, -1 if exception
+     */
+    HAKO_DefinePropAtom(ctx: JSContextPointer, this_val: JSValueConstPointer, prop_atom: JSAtom, prop_value: JSValueConstPointer, get: JSValueConstPointer, set: JSValueConstPointer, configurable: LEPUS_BOOL, enumerable: LEPUS_BOOL, has_value: LEPUS_BOOL): LEPUS_BOOL;
+    /**
+     * Duplicates an atom reference
+     *
+     * @param ctx Context to use
+     * @param atom Atom to duplicate
+     * @returns LEPUSAtom - The same atom with its reference count incremented
+     */
+    HAKO_DupAtom(ctx: JSContextPointer, atom: JSAtom): JSAtom;
+    /**
+     * Frees an atom reference
+     *
+     * @param ctx Context to use
+     * @param atom Atom to free
+     */
+    HAKO_FreeAtom(ctx: JSContextPointer, atom: JSAtom): void;
+    /**
+     * Gets a property value by atom
+     *
+     * @param ctx Context to use
+     * @param this_val Object to get property from
+     * @param prop_atom Property name atom
+     * @returns LEPUSValue* - Property value, NULL if an exception occurred
+     */
+    HAKO_GetPropAtom(ctx: JSContextPointer, this_val: JSValueConstPointer, prop_atom: JSAtom): JSValuePointer;
+    /**
+     * Gets several property values in one call
+     *
+     * @param ctx Context to use
+     * @param this_val Object to get properties from
+     * @param atoms Array of count property name atoms
+     * @param count Number of properties
+     * @param out_values Output array of count value pointers (must be freed)
+     * @param out_status Output array of count bytes, 1 where the slot threw
+     * @returns int - Number of slots that threw
+     */
+    HAKO_GetProps(ctx: JSContextPointer, this_val: JSValueConstPointer, atoms: number, count: number, out_values: number, out_status: number): number;
+    /**
+     * Interns a property name as an atom
+     *
+     * @param ctx Context to use
+     * @param utf8 Property name as UTF-8
+     * @param len Length of the name in bytes
+     * @returns LEPUSAtom - The atom (must be freed with HAKO_FreeAtom), 0 on error
+     */
+    HAKO_NewAtom(ctx: JSContextPointer, utf8: number, len: number): JSAtom;
+    /**
+     * Sets a property value by atom
+     *
+     * @param ctx Context to use
+     * @param this_val Object to set property on
+     * @param prop_atom Property name atom
+     * @param prop_value Property value
+     * @returns LEPUS_BOOL - True if successful, false if failed, -1 if exception
+     */
+    HAKO_SetPropAtom(ctx: JSContextPointer, this_val: JSValueConstPointer, prop_atom: JSAtom, prop_value: JSValueConstPointer): LEPUS_BOOL;
+    /**
+     * Sets several property values in one call
+     *
+     * @param ctx Context to use
+     * @param this_val Object to set properties on
+     * @param atoms Array of count property name atoms
+     * @param count Number of properties
+     * @param values Contiguous array of count LEPUSValues, duplicated
+     * @param out_status Output array of count bytes, 1 where the slot threw
+     * @param out_errors Optional output array of count error pointers, or NULL
+     * @returns int - Number of slots that threw
+     */
+    HAKO_SetProps(ctx: JSContextPointer, this_val: JSValueConstPointer, atoms: number, count: number, values: number, out_status: number, out_errors: number): number;
+
     // Binary JSON
     /**
      * Decodes a value from binary JSON format
@@ -213,6 +300,20 @@ export interface HakoExports {
      * @returns LEPUSContext* - Newly created context
      */
     HAKO_NewContext(rt: JSRuntimePointer, intrinsics: number): JSContextPointer;
+    /**
+     * Returns a context to the baseline recorded by
+     *
+     * @param ctx Context to reset
+     * @returns int - Number of global properties that could not be removed or
+     */
+    HAKO_ResetContext(ctx: JSContextPointer): number;
+    /**
+     * Records the global object's properties as the state that
+     *
+     * @param ctx Context to record
+     * @returns int - 0 on success, -1 on error (exception set)
+     */
+    HAKO_SaveContextBaseline(ctx: JSContextPointer): number;
     /**
      * sets opaque data for the context. you are responsible for freeing the
      *
@@ -333,6 +434,59 @@ export interface HakoExports {
      * @returns LEPUSValue* - Evaluation result
      */
     HAKO_Eval(ctx: JSContextPointer, js_code: CString, js_code_length: number, filename: CString, detect_module: LEPUS_BOOL, eval_flags: number): JSValuePointer;
+    /**
+     * Frees an eval buffer without evaluating it
+     *
+     * @param buffer Buffer from HAKO_EvalBufferBegin
+     */
+    HAKO_EvalBufferAbort(buffer: number): void;
+    /**
+     * Appends a chunk of UTF-8 source to an eval buffer
+     *
+     * @param buffer Buffer from HAKO_EvalBufferBegin
+     * @param chunk Chunk bytes; a multi-byte character may span two chunks
+     * @param chunk_length Chunk size in bytes
+     * @returns int - 0 on success, -1 on failure
+     */
+    HAKO_EvalBufferAppend(buffer: number, chunk: number, chunk_length: number): number;
+    /**
+     * Starts buffering a source that arrives in chunks for one eval
+     *
+     * @param ctx Context the source will be evaluated in
+     * @param size_hint Expected source size in bytes, or 0 if unknown
+     * @returns HakoEvalBuffer* - Buffer to append to, NULL on allocation failure
+     */
+    HAKO_EvalBufferBegin(ctx: JSContextPointer, size_hint: number): number;
+    /**
+     * Evaluates the source held by an eval buffer and frees the buffer
+     *
+     * @param buffer Buffer from HAKO_EvalBufferBegin
+     * @param filename Filename for error reporting
+     * @param detect_module Whether to auto-detect module code
+     * @param eval_flags Evaluation flags
+     * @returns LEPUSValue* - Evaluation result, or NULL if buffer is NULL
+     */
+    HAKO_EvalBufferEnd(buffer: number, filename: CString, detect_module: LEPUS_BOOL, eval_flags: number): JSValuePointer;
+    /**
+     * Compiles a script once for repeated runs with HAKO_RunPrepared
+     *
+     * @param ctx Context to compile in
+     * @param js_code Script source
+     * @param js_code_length Source length in bytes
+     * @param filename Filename for error reporting
+     * @param eval_flags Evaluation flags (LEPUS_EVAL_FLAG_STRICT, etc.)
+     * @returns LEPUSValue* - Prepared script, or an exception on syntax errors
+     */
+    HAKO_PrepareScript(ctx: JSContextPointer, js_code: CString, js_code_length: number, filename: CString, eval_flags: number): JSValuePointer;
+    /**
+     * Runs a script prepared with HAKO_PrepareScript
+     *
+     * @param ctx Context to run in
+     * @param prepared Prepared script handle
+     * @param this_obj Value of `this` for the script, or NULL for the global
+     * @returns LEPUSValue* - Completion value of the script
+     */
+    HAKO_RunPrepared(ctx: JSContextPointer, prepared: JSValueConstPointer, this_obj: JSValueConstPointer): JSValuePointer;
 
     // Interrupt Handling
     /**
@@ -427,6 +581,42 @@ export interface HakoExports {
      * @returns LEPUSValue* - Module namespace
      */
     HAKO_GetModuleNamespace(ctx: JSContextPointer, module_func_obj: JSValueConstPointer): JSValuePointer;
+    /**
+     * Drops compiled modules cached for every context of the runtime
+     *
+     * @param rt Runtime whose module cache to invalidate
+     * @param module_name Normalized module name, or NULL to drop every module
+     */
+    HAKO_InvalidateModuleCache(rt: JSRuntimePointer, module_name: CString): void;
+    /**
+     * Registers a bundle of precompiled modules with the runtime
+     *
+     * @param rt Runtime to register the bundle with
+     * @param bundle_data Bundle allocated with HAKO_RuntimeMalloc; on success the
+     * @param bundle_length Bundle size in bytes
+     * @returns int - Number of modules in the bundle, or -1 if it is malformed
+     */
+    HAKO_LoadBundle(rt: JSRuntimePointer, bundle_data: number, bundle_length: number): number;
+    /**
+     * Registers a precompiled module under a name
+     *
+     * @param rt Runtime to register the module with
+     * @param module_name Module name as it appears after normalization
+     * @param bytecode Module bytecode from HAKO_CompileToByteCode; it is copied
+     * @param bytecode_length Bytecode size in bytes
+     * @returns int - 0 on success, -1 on failure
+     */
+    HAKO_RegisterModuleBytecode(rt: JSRuntimePointer, module_name: CString, bytecode: number, bytecode_length: number): number;
+    /**
+     * Registers module source code under a name
+     *
+     * @param rt Runtime to register the module with
+     * @param module_name Module name as it appears after normalization
+     * @param source Module source code; it is copied
+     * @param source_length Source length in bytes
+     * @returns int - 0 on success, -1 on failure
+     */
+    HAKO_RegisterModuleSource(rt: JSRuntimePointer, module_name: CString, source: number, source_length: number): number;
     /**
      * Disables module loader for the runtime
      *
@@ -440,6 +630,26 @@ export interface HakoExports {
      * @param use_custom_normalize Whether to use custom module name normalization
      */
     HAKO_RuntimeEnableModuleLoader(rt: JSRuntimePointer, use_custom_normalize: number): void;
+    /**
+     * Enables batched prefetch of module import graphs
+     *
+     * @param rt Runtime to configure
+     * @param enabled Whether to prefetch imports
+     */
+    HAKO_RuntimeSetModulePrefetch(rt: JSRuntimePointer, enabled: LEPUS_BOOL): void;
+    /**
+     * Frees every bundle registered with HAKO_LoadBundle
+     *
+     * @param rt Runtime whose bundles to free
+     */
+    HAKO_UnloadBundles(rt: JSRuntimePointer): void;
+    /**
+     * Removes a module registered with HAKO_RegisterModuleBytecode or
+     *
+     * @param rt Runtime the module is registered with
+     * @param module_name Module name
+     */
+    HAKO_UnregisterModule(rt: JSRuntimePointer, module_name: CString): void;
 
     // Promise
     /**
@@ -491,6 +701,101 @@ export interface HakoExports {
      */
     HAKO_PromiseState(ctx: JSContextPointer, promise: JSValueConstPointer): number;
 
+    // Raw Values
+    /**
+     * Converts a raw value to a double
+     *
+     * @param ctx Context to use
+     * @param value Raw value to convert
+     * @returns double - Number value, NaN if the conversion failed
+     */
+    HAKO_GetFloat64Raw(ctx: JSContextPointer, value: JSValueRaw): number;
+    /**
+     * Gets the raw null value
+     *
+     * @returns LEPUSValue - Raw null
+     */
+    HAKO_GetNullRaw(): JSValueRaw;
+    /**
+     * Gets the raw undefined value
+     *
+     * @returns LEPUSValue - Raw undefined
+     */
+    HAKO_GetUndefinedRaw(): JSValueRaw;
+    /**
+     * Checks if a raw value is null
+     *
+     * @param value Raw value to check
+     * @returns LEPUS_BOOL - True if value is null
+     */
+    HAKO_IsNullRaw(value: JSValueRaw): LEPUS_BOOL;
+    /**
+     * Checks if a raw value is undefined
+     *
+     * @param value Raw value to check
+     * @returns LEPUS_BOOL - True if value is undefined
+     */
+    HAKO_IsUndefinedRaw(value: JSValueRaw): LEPUS_BOOL;
+    /**
+     * Creates a raw boolean value
+     *
+     * @param ctx Context to use
+     * @param value Boolean value (0 or 1)
+     * @returns LEPUSValue - Raw boolean
+     */
+    HAKO_NewBoolRaw(ctx: JSContextPointer, value: number): JSValueRaw;
+    /**
+     * Creates a raw number value
+     *
+     * @param ctx Context to use
+     * @param num Number value
+     * @returns LEPUSValue - Raw number
+     */
+    HAKO_NewFloat64Raw(ctx: JSContextPointer, num: number): JSValueRaw;
+    /**
+     * Boxes a raw value into a new value pointer
+     *
+     * @param ctx Context to use
+     * @param value Raw value, duplicated into the new pointer
+     * @returns LEPUSValue* - Pointer to the boxed value
+     */
+    HAKO_RawToValue(ctx: JSContextPointer, value: JSValueRaw): JSValuePointer;
+    /**
+     * Sets a property to a raw value by atom
+     *
+     * @param ctx Context to use
+     * @param this_val Object to set property on
+     * @param prop_atom Property name atom
+     * @param prop_value Raw property value, duplicated
+     * @returns LEPUS_BOOL - True if successful, false if failed, -1 if exception
+     */
+    HAKO_SetPropAtomRaw(ctx: JSContextPointer, this_val: JSValueConstPointer, prop_atom: JSAtom, prop_value: JSValueRaw): LEPUS_BOOL;
+    /**
+     * Sets a property to a raw value
+     *
+     * @param ctx Context to use
+     * @param this_val Object to set property on
+     * @param prop_name Property name
+     * @param prop_value Raw property value, duplicated
+     * @returns LEPUS_BOOL - True if successful, false if failed, -1 if exception
+     */
+    HAKO_SetPropRaw(ctx: JSContextPointer, this_val: JSValueConstPointer, prop_name: JSValueConstPointer, prop_value: JSValueRaw): LEPUS_BOOL;
+    /**
+     * Gets the type of a raw value
+     *
+     * @param ctx Context to use
+     * @param value Raw value to check
+     * @returns HAKOTypeOf - Type identifier
+     */
+    HAKO_TypeOfRaw(ctx: JSContextPointer, value: JSValueRaw): HAKOTypeOf;
+    /**
+     * Reads the raw NaN-boxed value stored behind a value pointer
+     *
+     * @param value Value pointer to read
+     * @returns LEPUSValue - Borrowed raw value, valid while the pointer is alive
+     */
+    HAKO_ValueToRaw(value: JSValueConstPointer): JSValueRaw;
+
     // Runtime Management
     /**
      * Frees a Hako runtime and associated resources
@@ -498,6 +803,25 @@ export interface HakoExports {
      * @param rt Runtime to free
      */
     HAKO_FreeRuntime(rt: JSRuntimePointer): void;
+    /**
+     * Gets the template context captured in a pre-initialized build
+     *
+     * @returns LEPUSContext* - Captured context, or NULL if the module was not
+     */
+    HAKO_GetPreinitializedContext(): JSContextPointer;
+    /**
+     * Gets the runtime captured in a pre-initialized build
+     *
+     * @returns LEPUSRuntime* - Captured runtime, or NULL if the module was not
+     */
+    HAKO_GetPreinitializedRuntime(): JSRuntimePointer;
+    /**
+     * Reads the compiled script cache counters
+     *
+     * @param rt Runtime to query
+     * @param out_stats Receives a HakoScriptCacheStats (six u32 fields)
+     */
+    HAKO_GetScriptCacheStats(rt: JSRuntimePointer, out_stats: number): void;
     /**
      * Get the current debug info stripping configuration
      *
@@ -511,6 +835,12 @@ export interface HakoExports {
      * @returns LEPUSRuntime* - Pointer to the newly created runtime
      */
     HAKO_NewRuntime(): JSRuntimePointer;
+    /**
+     * Drops every entry of the compiled script cache
+     *
+     * @param rt Runtime whose cache to empty
+     */
+    HAKO_PurgeScriptCache(rt: JSRuntimePointer): void;
     /**
      * Sets memory limit for the runtime
      *
@@ -518,6 +848,20 @@ export interface HakoExports {
      * @param limit Memory limit in bytes, or -1 to disable limit
      */
     HAKO_RuntimeSetMemoryLimit(rt: JSRuntimePointer, limit: number): void;
+    /**
+     * Records the runtime and context a pre-initialized build starts with
+     *
+     * @param rt Initialized runtime
+     * @param ctx Initialized template context of rt
+     */
+    HAKO_SetPreinitialized(rt: JSRuntimePointer, ctx: JSContextPointer): void;
+    /**
+     * Sets the size limit of the runtime's compiled script cache
+     *
+     * @param rt Runtime to configure
+     * @param limit Cache size limit in bytes, or 0 to disable and empty the cache
+     */
+    HAKO_SetScriptCacheLimit(rt: JSRuntimePointer, limit: number): void;
     /**
      * Configure which debug info is stripped from the compiled code
      *
@@ -616,6 +960,33 @@ export interface HakoExports {
      * @returns LEPUSValue* - New string
      */
     HAKO_NewString(ctx: JSContextPointer, string: CString): JSValuePointer;
+    /**
+     * Creates a new string from Latin-1 bytes
+     *
+     * @param ctx Context to create in
+     * @param latin1 Latin-1 (ISO-8859-1) bytes
+     * @param len Length in bytes
+     * @returns LEPUSValue* - New string, or exception if failed
+     */
+    HAKO_NewStringLatin1(ctx: JSContextPointer, latin1: number, len: number): JSValuePointer;
+    /**
+     * Creates a new string from UTF-8 with an explicit length
+     *
+     * @param ctx Context to create in
+     * @param utf8 UTF-8 bytes
+     * @param len Length in bytes
+     * @returns LEPUSValue* - New string, or exception if failed
+     */
+    HAKO_NewStringLen(ctx: JSContextPointer, utf8: number, len: number): JSValuePointer;
+    /**
+     * Creates a new string from UTF-16 code units
+     *
+     * @param ctx Context to create in
+     * @param utf16 Little-endian UTF-16 code units
+     * @param len Length in code units
+     * @returns LEPUSValue* - New string, or exception if failed
+     */
+    HAKO_NewStringUTF16(ctx: JSContextPointer, utf16: number, len: number): JSValuePointer;
     /**
      * Creates a new symbol
      *
@@ -649,6 +1020,14 @@ export interface HakoExports {
      * @param str String to free
      */
     HAKO_FreeCString(ctx: JSContextPointer, str: CString): void;
+    /**
+     * Frees a value by handle
+     *
+     * @param ctx Context the value belongs to
+     * @param handle Handle returned by HAKO_ValueToHandle
+     * @returns LEPUS_BOOL - True if freed, false if detected as stale
+     */
+    HAKO_FreeHandle(ctx: JSContextPointer, handle: number): LEPUS_BOOL;
     /**
      * Frees a JavaScript value pointer
      *
@@ -663,6 +1042,21 @@ export interface HakoExports {
      * @param value Value pointer to free
      */
     HAKO_FreeValuePointerRuntime(rt: JSRuntimePointer, value: JSValuePointer): void;
+    /**
+     * Gets the number of value pointers currently live in a runtime
+     *
+     * @param rt Runtime to inspect
+     * @returns uint32_t - Number of live value slots
+     */
+    HAKO_GetLiveHandleCount(rt: JSRuntimePointer): number;
+    /**
+     * Resolves a handle back to its value pointer
+     *
+     * @param ctx Context the value belongs to
+     * @param handle Handle returned by HAKO_ValueToHandle
+     * @returns LEPUSValue* - Value pointer, or NULL if detected as stale
+     */
+    HAKO_HandleToValue(ctx: JSContextPointer, handle: number): JSValuePointer;
     /**
      * Allocates memory using the context's allocator
      *
@@ -671,6 +1065,29 @@ export interface HakoExports {
      * @returns void* - Pointer to the allocated memory
      */
     HAKO_Malloc(ctx: JSContextPointer, size: number): number;
+    /**
+     * Closes a value scope and frees the values recorded in it
+     *
+     * @param ctx Context to use
+     * @param scope Scope id returned by HAKO_PushValueScope
+     * @returns int - Number of values freed, or -1 if the scope is not open
+     */
+    HAKO_PopValueScope(ctx: JSContextPointer, scope: number): number;
+    /**
+     * Moves a value pointer out of its scope into the enclosing one
+     *
+     * @param ctx Context to use
+     * @param value Value pointer to promote
+     * @returns LEPUS_BOOL - True if promoted, false if the value was not scoped
+     */
+    HAKO_PromoteValue(ctx: JSContextPointer, value: JSValueConstPointer): LEPUS_BOOL;
+    /**
+     * Opens a value scope
+     *
+     * @param ctx Context to use
+     * @returns uint32_t - Scope id (its nesting depth), or 0 on failure
+     */
+    HAKO_PushValueScope(ctx: JSContextPointer): number;
     /**
      * Frees memory that was allocated by a lepus allocator function
      *
@@ -686,6 +1103,14 @@ export interface HakoExports {
      * @returns void* - Pointer to the allocated memory
      */
     HAKO_RuntimeMalloc(rt: JSRuntimePointer, size: number): number;
+    /**
+     * Gets the generation-tagged handle of a value pointer
+     *
+     * @param ctx Context the value belongs to
+     * @param value Value pointer returned by a HAKO_ function
+     * @returns uint32_t - Handle for the value, or 0 if the pointer is not live
+     */
+    HAKO_ValueToHandle(ctx: JSContextPointer, value: JSValueConstPointer): number;
 
     // Value Operations
     /**
@@ -707,6 +1132,27 @@ export interface HakoExports {
      * @returns LEPUSValue* - Function result
      */
     HAKO_Call(ctx: JSContextPointer, func_obj: JSValueConstPointer, this_obj: JSValueConstPointer, argc: number, argv_ptrs: number): JSValuePointer;
+    /**
+     * Calls a function with a contiguous argument array
+     *
+     * @param ctx Context to use
+     * @param func_obj Function to call
+     * @param this_obj This value
+     * @param argc Number of arguments
+     * @param argv Array of argc LEPUSValues, or NULL to use the scratch argv
+     * @returns LEPUSValue* - Function result
+     */
+    HAKO_CallArgv(ctx: JSContextPointer, func_obj: JSValueConstPointer, this_obj: JSValueConstPointer, argc: number, argv: number): JSValuePointer;
+    /**
+     * Calls a constructor with a contiguous argument array
+     *
+     * @param ctx Context to use
+     * @param func_obj Constructor to call
+     * @param argc Number of arguments
+     * @param argv Array of argc LEPUSValues, or NULL to use the scratch argv
+     * @returns LEPUSValue* - Constructed object
+     */
+    HAKO_CallConstructorArgv(ctx: JSContextPointer, func_obj: JSValueConstPointer, argc: number, argv: number): JSValuePointer;
     /**
      * Copy the buffer from a guest ArrayBuffer
      *
@@ -748,6 +1194,28 @@ export interface HakoExports {
      * @returns JSBorrowedChar* - JSON string representation
      */
     HAKO_Dump(ctx: JSContextPointer, obj: JSValueConstPointer): CString;
+    /**
+     * Executes a stream of batched value operations
+     *
+     * @param ctx Context to use
+     * @param ops Instruction stream
+     * @param ops_len Number of uint32 words in the stream
+     * @param register_count Number of registers (max HAKO_BATCH_MAX_REGISTERS)
+     * @param out Output buffer for TYPEOF and EXPORT results
+     * @param out_len Number of uint32 slots in the output buffer
+     * @returns LEPUSValue* - Exception if error occurred, NULL otherwise
+     */
+    HAKO_ExecBatch(ctx: JSContextPointer, ops: number, ops_len: number, register_count: number, out: number, out_len: number): JSValuePointer;
+    /**
+     * Builds a value graph from the native graph format
+     *
+     * @param ctx Context to use
+     * @param data Encoded graph
+     * @param len Length of the encoded graph in bytes
+     * @param max_depth Maximum nesting depth, 0 for HAKO_NATIVE_DEFAULT_MAX_DEPTH
+     * @returns LEPUSValue* - Pointer to the decoded value, or exception if failed
+     */
+    HAKO_FromNative(ctx: JSContextPointer, data: number, len: number, max_depth: number): JSValuePointer;
     /**
      * Gets the class ID of a value
      *
@@ -790,6 +1258,17 @@ export interface HakoExports {
      * @returns LEPUSValue* - Exception if error occurred, NULL otherwise
      */
     HAKO_GetOwnPropertyNames(ctx: JSContextPointer, out_ptrs: number, out_len: number, obj: JSValueConstPointer, flags: number): JSValuePointer;
+    /**
+     * Gets own property names of an object as one packed buffer
+     *
+     * @param ctx Context to use
+     * @param obj Object to get property names from
+     * @param flags Property name flags, as for HAKO_GetOwnPropertyNames
+     * @param pack_flags HAKO_PACK_KEY_* flags
+     * @param out_len Pointer to store the buffer length in bytes
+     * @returns uint8_t* - Buffer to free with HAKO_Free, NULL on exception
+     */
+    HAKO_GetOwnPropertyNamesPacked(ctx: JSContextPointer, obj: JSValueConstPointer, flags: number, pack_flags: number, out_len: number): number;
     /**
      * Gets a property value by name
      *
@@ -808,6 +1287,53 @@ export interface HakoExports {
      * @returns LEPUSValue* - Property value
      */
     HAKO_GetPropNumber(ctx: JSContextPointer, this_val: JSValueConstPointer, prop_name: number): JSValuePointer;
+    /**
+     * Gets the context scratch argv buffer
+     *
+     * @param ctx Context to use
+     * @param argc Number of arguments the buffer must hold
+     * @returns LEPUSValue* - Scratch buffer, or NULL if it is not available
+     */
+    HAKO_GetScratchArgv(ctx: JSContextPointer, argc: number): number;
+    /**
+     * Writes the Latin-1 representation of a value into a buffer
+     *
+     * @param ctx Context to use
+     * @param value Value to convert
+     * @param buf Destination buffer, may be NULL when capacity is 0
+     * @param capacity Size of the buffer in bytes
+     * @returns int32_t - Required length in bytes, -1 on exception
+     */
+    HAKO_GetStringLatin1(ctx: JSContextPointer, value: JSValueConstPointer, buf: number, capacity: number): number;
+    /**
+     * Writes the UTF-16 representation of a value into a buffer
+     *
+     * @param ctx Context to use
+     * @param value Value to convert
+     * @param buf Destination buffer, may be NULL when capacity is 0
+     * @param capacity Size of the buffer in code units
+     * @returns int32_t - Required length in code units, -1 on exception
+     */
+    HAKO_GetStringUTF16(ctx: JSContextPointer, value: JSValueConstPointer, buf: number, capacity: number): number;
+    /**
+     * Writes the UTF-8 representation of a value into a buffer
+     *
+     * @param ctx Context to use
+     * @param value Value to convert
+     * @param buf Destination buffer, may be NULL when capacity is 0
+     * @param capacity Size of the buffer in bytes
+     * @returns int32_t - Required length in bytes, -1 on exception
+     */
+    HAKO_GetStringUTF8(ctx: JSContextPointer, value: JSValueConstPointer, buf: number, capacity: number): number;
+    /**
+     * Gets the characters of a string value without copying them
+     *
+     * @param ctx Context to use
+     * @param value String value to view
+     * @param out_view Receives the length and character width
+     * @returns const void* - Characters, NULL for non-strings or on exception
+     */
+    HAKO_GetStringView(ctx: JSContextPointer, value: JSValueConstPointer, out_view: number): number;
     /**
      * Gets the description or key of a symbol
      *
@@ -824,6 +1350,17 @@ export interface HakoExports {
      * @returns HAKO_TypedArrayType - Type id
      */
     HAKO_GetTypedArrayType(ctx: JSContextPointer, value: JSValueConstPointer): number;
+    /**
+     * Invokes a method by atom with a contiguous argument array
+     *
+     * @param ctx Context to use
+     * @param this_obj Object to invoke the method on
+     * @param atom Method name atom
+     * @param argc Number of arguments
+     * @param argv Array of argc LEPUSValues, or NULL to use the scratch argv
+     * @returns LEPUSValue* - Method result
+     */
+    HAKO_InvokeArgv(ctx: JSContextPointer, this_obj: JSValueConstPointer, atom: JSAtom, argc: number, argv: number): JSValuePointer;
     /**
      * Checks if a value is an array
      *
@@ -908,6 +1445,18 @@ export interface HakoExports {
      * @returns LEPUSValue* - JSON string representation
      */
     HAKO_ToJson(ctx: JSContextPointer, val: JSValueConstPointer, indent: number): JSValuePointer;
+    /**
+     * Serializes a value graph into the native graph format
+     *
+     * @param ctx Context to use
+     * @param value Value to serialize
+     * @param max_depth Maximum nesting depth, 0 for HAKO_NATIVE_DEFAULT_MAX_DEPTH
+     * @param max_bytes Maximum output size in bytes, 0 for no limit
+     * @param flags HAKO_NATIVE_* flags
+     * @param out_len Pointer to store the output length in bytes
+     * @returns uint8_t* - Buffer to free with HAKO_Free, NULL on exception
+     */
+    HAKO_ToNative(ctx: JSContextPointer, value: JSValueConstPointer, max_depth: number, max_bytes: number, flags: number, out_len: number): number;
     /**
      * Gets the type of a value
      *
@@ -42,6 +42,15 @@ export type JSValuePointer = number;
  * Maps to LEPUSValueConst* in C code.
  */
 export type JSValueConstPointer = number;
+/**
+ * A raw NaN-boxed JavaScript value passed by value across the boundary.
+ * Maps to LEPUSValue (not a pointer) in C code.
+ */
+export type JSValueRaw = bigint;
+/**
+ * Size in bytes of a LEPUSValue in WebAssembly memory (NaN-boxed on wasm32).
+ */
+export const LEPUS_VALUE_SIZE = 8;
 /**
  * A numerical value representing the JavaScript type of a value.
  */
@@ -52,6 +61,10 @@ export type HAKOTypeOf = number;
  * Maps to LEPUSAtom in C code.
  */
 export type JSAtom = number;
+/**
+ * Maximum number of property name atoms a context keeps interned.
+ */
+export const ATOM_CACHE_LIMIT = 1024;
 /**
  * Pointer to a null-terminated C string in WebAssembly memory.
  * Maps to CString in C code.
@@ -119,8 +132,12 @@ export type HostCallbackFunction<VmHandle> = (
   ...args: VmHandle[]
   // biome-ignore lint/suspicious/noConfusingVoidType: you're annoying
 ) => VmHandle | VmCallResult<VmHandle> | void;
+/**
+ * Result of a module loader. A version (such as an etag) on a source result
+ * lets the runtime compile that module once and share it across contexts.
+ */
 export type ModuleLoaderResult =
-  | { type: "source"; data: string } // Source code
+  | { type: "source"; data: string; version?: string } // Source code
   | { type: "precompiled"; data: number } // Pointer to LEPUSModuleDef
   | { type: "error" } // Module not found
   | null;
@@ -428,6 +445,55 @@ export interface StripOptions {
    */
   stripDebug?: boolean;
 }
+/**
+ * Bytecode kept resident in the WebAssembly heap so it is not copied in
+ * for every evaluation. Each evaluation still deserializes it in full.
+ */
+export interface PinnedByteCode {
+  /** Address of the bytecode in WebAssembly memory */
+  readonly pointer: number;
+  /** Length of the bytecode in bytes */
+  readonly length: number;
+  /** False once the bytecode has been released */
+  alive: boolean;
+  /** Releases the bytecode buffer */
+  dispose(): void;
+  [Symbol.dispose](): void;
+}
+
+/**
+ * Source buffered chunk by chunk inside the WebAssembly heap and evaluated
+ * in one piece, created by {@link VMContext.createEvalBuffer}
+ */
+export interface EvalBuffer {
+  /** False once the buffer has been evaluated or aborted */
+  alive: boolean;
+  /** Appends a chunk of source; byte chunks must be UTF-8 */
+  append(chunk: string | Uint8Array): void;
+  /** Evaluates the buffered source and releases the buffer */
+  end(options?: ContextEvalOptions): VMContextResult<VMValue>;
+  /** Releases the buffer without evaluating it */
+  abort(): void;
+  [Symbol.dispose](): void;
+}
+
+/**
+ * Counters of a runtime's compiled script cache
+ */
+export interface ScriptCacheStats {
+  /** Evaluations that reused cached bytecode */
+  hits: number;
+  /** Evaluations that compiled and stored the script */
+  misses: number;
+  /** Entries dropped to stay within the limit */
+  evictions: number;
+  /** Scripts currently cached */
+  entries: number;
+  /** Bytes currently charged against the limit */
+  bytes: number;
+  /** Size limit in bytes, 0 when the cache is disabled */
+  limit: number;
+}
 /**
  * Options for evaluating JavaScript code in a context.
  */
@@ -525,6 +591,101 @@ export const PROPERTY_ENUM_COMPLIANT = 1 << 15;
  */
 export type PropertyEnumFlags = number;
 
+// Packed property name entry kinds, mirrors HAKO_PackedKeyKind in hako.h
+export const PACKED_KEY_INDEX = 0;
+export const PACKED_KEY_STRING = 1;
+export const PACKED_KEY_SYMBOL = 2;
+
+// HAKO_GetOwnPropertyNamesPacked flags
+export const PACK_KEY_ATOMS = 1 << 0;
+export const PACK_KEY_UTF8 = 1 << 1;
+
+//=============================================================================
+// Batched Operations
+//=============================================================================
+
+// BatchOp constants, mirrors HAKO_BatchOp in hako.h
+export const BATCH_OP_LOAD = 1; // dst, JSValueConstPointer
+export const BATCH_OP_LOAD_STRING = 2; // dst, CString pointer
+export const BATCH_OP_LOAD_INT = 3; // dst, int32
+export const BATCH_OP_GET = 4; // dst, obj, key
+export const BATCH_OP_SET = 5; // obj, key, value
+export const BATCH_OP_DEFINE = 6; // obj, key, value
+export const BATCH_OP_CALL = 7; // dst, func, this, argc, ...args
+export const BATCH_OP_NEW = 8; // dst, ctor, argc, ...args
+export const BATCH_OP_TYPEOF = 9; // reg
+export const BATCH_OP_FREE = 10; // reg
+export const BATCH_OP_EXPORT = 11; // reg
+export const BATCH_MAX_REGISTERS = 256;
+
+//=============================================================================
+// Native Graph Format
+//=============================================================================
+
+// NativeTag constants, mirrors HAKO_NativeTag in hako.h
+export const NATIVE_VERSION = 1;
+export const NATIVE_NEW_KEY = 0xffffffff;
+export const NATIVE_UNDEFINED = 0;
+export const NATIVE_NULL = 1;
+export const NATIVE_FALSE = 2;
+export const NATIVE_TRUE = 3;
+export const NATIVE_INT32 = 4;
+export const NATIVE_FLOAT64 = 5;
+export const NATIVE_STRING = 6;
+export const NATIVE_ARRAY = 7;
+export const NATIVE_OBJECT = 8;
+export const NATIVE_REF = 9;
+export const NATIVE_BIGINT = 10;
+export const NATIVE_OPAQUE = 11;
+
+// HAKO_ToNative flags
+export const NATIVE_FLAG_REJECT_CYCLES = 1 << 0;
+
+/**
+ * Options controlling how a value graph is converted in one call.
+ */
+export interface NativeGraphOptions {
+  /**
+   * Maximum nesting depth of arrays and objects. Defaults to 256.
+   */
+  maxDepth?: number;
+  /**
+   * Maximum size of the encoded graph in bytes. Unlimited by default.
+   */
+  maxBytes?: number;
+  /**
+   * Throw on cyclic graphs instead of preserving the cycle.
+   * Shared references are preserved either way.
+   */
+  rejectCycles?: boolean;
+}
+
+//=============================================================================
+// Bytecode Bundles
+//=============================================================================
+
+// Bundle layout constants, mirror HAKO_BUNDLE_* in hako.h
+export const BUNDLE_MAGIC = 0x43424b48; // "HKBC"
+export const BUNDLE_VERSION = 1;
+export const BUNDLE_HEADER_SIZE = 12;
+export const BUNDLE_ENTRY_SIZE = 16;
+
+/**
+ * A precompiled module to place in a bytecode bundle.
+ */
+export interface BundleModule {
+  /**
+   * Name imports resolve to. It must match the fileName the module was
+   * compiled under, including the "file://" prefix added by
+   * compileToByteCode.
+   */
+  name: string;
+  /**
+   * Module bytecode from compileToByteCode
+   */
+  bytecode: Uint8Array;
+}
+
 //=============================================================================
 // JavaScript Types
 //=============================================================================
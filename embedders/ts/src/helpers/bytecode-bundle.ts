@@ -0,0 +1,59 @@
+/**
+ * bytecode-bundle.ts - Encoder for multi-module bytecode bundles
+ *
+ * A bundle packs many precompiled modules behind a single index (see
+ * HAKO_BUNDLE_MAGIC in hako.h) so a runtime can register all of them with
+ * one HAKO_LoadBundle call and deserialize each module only when it is
+ * first imported.
+ */
+
+import {
+  BUNDLE_ENTRY_SIZE,
+  BUNDLE_HEADER_SIZE,
+  BUNDLE_MAGIC,
+  BUNDLE_VERSION,
+  type BundleModule,
+} from "../etc/types";
+
+const encoder = new TextEncoder();
+
+/**
+ * Encodes precompiled modules into a bytecode bundle.
+ *
+ * @param modules - The modules to include; later duplicates of a name are
+ *                  never reached by imports
+ * @returns The encoded bundle
+ */
+export function encodeByteCodeBundle(
+  modules: ReadonlyArray<BundleModule>
+): Uint8Array {
+  const names = modules.map((module) => encoder.encode(module.name));
+  let size = BUNDLE_HEADER_SIZE + modules.length * BUNDLE_ENTRY_SIZE;
+  for (let i = 0; i < modules.length; i++) {
+    size += names[i].byteLength + modules[i].bytecode.byteLength;
+  }
+
+  const bundle = new Uint8Array(size);
+  const view = new DataView(bundle.buffer);
+  view.setUint32(0, BUNDLE_MAGIC, true);
+  view.setUint32(4, BUNDLE_VERSION, true);
+  view.setUint32(8, modules.length, true);
+
+  let offset = BUNDLE_HEADER_SIZE + modules.length * BUNDLE_ENTRY_SIZE;
+  for (let i = 0; i < modules.length; i++) {
+    const entry = BUNDLE_HEADER_SIZE + i * BUNDLE_ENTRY_SIZE;
+    const name = names[i];
+    const bytecode = modules[i].bytecode;
+
+    view.setUint32(entry, offset, true);
+    view.setUint32(entry + 4, name.byteLength, true);
+    bundle.set(name, offset);
+    offset += name.byteLength;
+
+    view.setUint32(entry + 8, offset, true);
+    view.setUint32(entry + 12, bytecode.byteLength, true);
+    bundle.set(bytecode, offset);
+    offset += bytecode.byteLength;
+  }
+  return bundle;
+}
@@ -0,0 +1,284 @@
+/**
+ * native-graph.ts - Encoder and decoder for the native value graph format
+ *
+ * HAKO_ToNative and HAKO_FromNative move a whole value graph across the
+ * boundary as a single tagged byte stream (see HAKO_NativeTag in hako.h).
+ * This module converts between that stream and host values in one pass,
+ * without further calls into the VM except for values that have no data
+ * representation.
+ */
+
+import {
+  NATIVE_ARRAY,
+  NATIVE_BIGINT,
+  NATIVE_FALSE,
+  NATIVE_FLOAT64,
+  NATIVE_INT32,
+  NATIVE_NEW_KEY,
+  NATIVE_NULL,
+  NATIVE_OBJECT,
+  NATIVE_OPAQUE,
+  NATIVE_REF,
+  NATIVE_STRING,
+  NATIVE_TRUE,
+  NATIVE_UNDEFINED,
+  NATIVE_VERSION,
+} from "../etc/types";
+
+const encoder = new TextEncoder();
+const decoder = new TextDecoder();
+
+/**
+ * Encodes a host value graph for HAKO_FromNative.
+ *
+ * Arrays and objects accepted by the callback are written as data, shared
+ * references become back-references and cycles are rejected.
+ *
+ * @param value - The host value to encode
+ * @param opaque - Returns a value pointer for a non-primitive value, or
+ *                 undefined to encode an object's own enumerable properties
+ * @returns The encoded graph
+ * @throws TypeError if the graph contains a circular reference
+ */
+export function encodeNativeGraph(
+  value: unknown,
+  opaque: (value: unknown) => number | undefined
+): Uint8Array {
+  let bytes = new Uint8Array(256);
+  let view = new DataView(bytes.buffer);
+  let offset = 0;
+  const keys = new Map<string, number>();
+  const objects = new Map<object, number>();
+  const active = new Set<object>();
+  const path: (string | number)[] = [];
+
+  const reserve = (size: number): void => {
+    if (offset + size <= bytes.byteLength) {
+      return;
+    }
+    let capacity = bytes.byteLength * 2;
+    while (capacity < offset + size) {
+      capacity *= 2;
+    }
+    const grown = new Uint8Array(capacity);
+    grown.set(bytes.subarray(0, offset));
+    bytes = grown;
+    view = new DataView(bytes.buffer);
+  };
+  const u8 = (value: number): void => {
+    reserve(1);
+    view.setUint8(offset++, value);
+  };
+  const u32 = (value: number): void => {
+    reserve(4);
+    view.setUint32(offset, value, true);
+    offset += 4;
+  };
+  const string = (value: string): void => {
+    // UTF-8 never takes more than three bytes per UTF-16 code unit
+    reserve(4 + value.length * 3);
+    const { written } = encoder.encodeInto(value, bytes.subarray(offset + 4));
+    view.setUint32(offset, written, true);
+    offset += 4 + written;
+  };
+
+  const writeObject = (obj: object): void => {
+    const index = objects.get(obj);
+    if (index !== undefined) {
+      if (active.has(obj)) {
+        const at = path
+          .map((key) => (typeof key === "number" ? `[${key}]` : `.${key}`))
+          .join("");
+        throw new TypeError(`Circular reference detected at root${at}`);
+      }
+      u8(NATIVE_REF);
+      u32(index);
+      return;
+    }
+    objects.set(obj, objects.size);
+    active.add(obj);
+    if (Array.isArray(obj)) {
+      u8(NATIVE_ARRAY);
+      u32(obj.length);
+      for (let i = 0; i < obj.length; i++) {
+        path.push(i);
+        write(obj[i]);
+        path.pop();
+      }
+    } else {
+      const record = obj as Record<string, unknown>;
+      const names = Object.keys(record);
+      u8(NATIVE_OBJECT);
+      u32(names.length);
+      for (const name of names) {
+        const keyIndex = keys.get(name);
+        if (keyIndex === undefined) {
+          keys.set(name, keys.size);
+          u32(NATIVE_NEW_KEY);
+          string(name);
+        } else {
+          u32(keyIndex);
+        }
+        path.push(name);
+        write(record[name]);
+        path.pop();
+      }
+    }
+    active.delete(obj);
+  };
+
+  const write = (value: unknown): void => {
+    switch (typeof value) {
+      case "undefined":
+        u8(NATIVE_UNDEFINED);
+        return;
+      case "boolean":
+        u8(value ? NATIVE_TRUE : NATIVE_FALSE);
+        return;
+      case "number":
+        if ((value | 0) === value && !Object.is(value, -0)) {
+          u8(NATIVE_INT32);
+          reserve(4);
+          view.setInt32(offset, value, true);
+          offset += 4;
+        } else {
+          u8(NATIVE_FLOAT64);
+          reserve(8);
+          view.setFloat64(offset, value, true);
+          offset += 8;
+        }
+        return;
+      case "string":
+        u8(NATIVE_STRING);
+        string(value);
+        return;
+      case "bigint":
+        u8(NATIVE_BIGINT);
+        string(value.toString());
+        return;
+    }
+    if (value === null) {
+      u8(NATIVE_NULL);
+      return;
+    }
+    const pointer = opaque(value);
+    if (pointer !== undefined) {
+      u8(NATIVE_OPAQUE);
+      u32(pointer);
+    } else if (typeof value === "object") {
+      writeObject(value);
+    } else {
+      throw new TypeError(`Unsupported value type ${typeof value}`);
+    }
+  };
+
+  u8(NATIVE_VERSION);
+  write(value);
+  return bytes.subarray(0, offset);
+}
+
+/**
+ * Decodes a native graph produced by HAKO_ToNative.
+ *
+ * @param bytes - The encoded graph, copied out of WebAssembly memory
+ * @param opaque - Converts an opaque value pointer (owned by the callee)
+ * @returns The decoded host value
+ * @throws Error if the stream is malformed
+ */
+export function decodeNativeGraph(
+  bytes: Uint8Array,
+  opaque: (pointer: number) => unknown
+): unknown {
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  const keys: string[] = [];
+  const objects: unknown[] = [];
+  let offset = 0;
+
+  const u32 = (): number => {
+    const value = view.getUint32(offset, true);
+    offset += 4;
+    return value;
+  };
+  const string = (): string => {
+    const length = u32();
+    const value = decoder.decode(bytes.subarray(offset, offset + length));
+    offset += length;
+    return value;
+  };
+
+  const read = (): unknown => {
+    const tag = view.getUint8(offset++);
+    switch (tag) {
+      case NATIVE_UNDEFINED:
+        return undefined;
+      case NATIVE_NULL:
+        return null;
+      case NATIVE_FALSE:
+        return false;
+      case NATIVE_TRUE:
+        return true;
+      case NATIVE_INT32: {
+        const value = view.getInt32(offset, true);
+        offset += 4;
+        return value;
+      }
+      case NATIVE_FLOAT64: {
+        const value = view.getFloat64(offset, true);
+        offset += 8;
+        return value;
+      }
+      case NATIVE_STRING:
+        return string();
+      case NATIVE_BIGINT:
+        return BigInt(string());
+      case NATIVE_ARRAY: {
+        const length = u32();
+        const result: unknown[] = new Array(length);
+        objects.push(result);
+        for (let i = 0; i < length; i++) {
+          result[i] = read();
+        }
+        return result;
+      }
+      case NATIVE_OBJECT: {
+        const count = u32();
+        const result: Record<string, unknown> = {};
+        objects.push(result);
+        for (let i = 0; i < count; i++) {
+          const keyIndex = u32();
+          let key: string;
+          if (keyIndex === NATIVE_NEW_KEY) {
+            key = string();
+            keys.push(key);
+          } else {
+            key = keys[keyIndex];
+          }
+          if (key === "__proto__") {
+            // Keep it an own data property instead of setting the prototype
+            Object.defineProperty(result, key, {
+              value: read(),
+              enumerable: true,
+              configurable: true,
+              writable: true,
+            });
+          } else {
+            result[key] = read();
+          }
+        }
+        return result;
+      }
+      case NATIVE_REF:
+        return objects[u32()];
+      case NATIVE_OPAQUE:
+        return opaque(u32());
+      default:
+        throw new Error(`Invalid native graph tag ${tag} at ${offset - 1}`);
+    }
+  };
+
+  const version = view.getUint8(offset++);
+  if (version !== NATIVE_VERSION) {
+    throw new Error(`Unsupported native graph version ${version}`);
+  }
+  return read();
+}
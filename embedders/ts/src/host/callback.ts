@@ -34,6 +34,45 @@ import type { HakoRuntime } from "./runtime";
 const HAKO_MODULE_SOURCE_STRING = 0;
 const HAKO_MODULE_SOURCE_PRECOMPILED = 1;
 const HAKO_MODULE_SOURCE_ERROR = 2;
+// Size of HakoModuleSource: type, source or module pointer, version pointer
+const MODULE_SOURCE_SIZE = 12;
+// Size of HakoModulePrefetch: name, source and version pointers
+const MODULE_PREFETCH_SIZE = 12;
+
+/**
+ * Mirrors the engine's default module name normalization, which resolves
+ * "./" and "../" specifiers against the directory of the base module.
+ */
+function defaultNormalizeModuleName(
+  baseName: string,
+  moduleName: string
+): string {
+  if (!moduleName.startsWith(".")) {
+    return moduleName;
+  }
+  const slash = baseName.lastIndexOf("/");
+  let dir = slash >= 0 ? baseName.slice(0, slash) : "";
+  let rest = moduleName;
+  for (;;) {
+    if (rest.startsWith("./")) {
+      rest = rest.slice(2);
+    } else if (rest.startsWith("../")) {
+      if (dir === "") {
+        break;
+      }
+      const last = dir.lastIndexOf("/");
+      const segment = dir.slice(last + 1);
+      if (segment === "." || segment === "..") {
+        break;
+      }
+      dir = last >= 0 ? dir.slice(0, last) : "";
+      rest = rest.slice(3);
+    } else {
+      break;
+    }
+  }
+  return dir === "" ? rest : `${dir}/${rest}`;
+}
 
 /**
  * Manages bidirectional callbacks between the host JavaScript environment and the PrimJS VM.
@@ -132,6 +171,24 @@ export class CallbackManager {
           );
         },
 
+        load_modules: (
+          rtPtr: number,
+          ctxPtr: number,
+          count: number,
+          baseNamesPtr: number,
+          moduleNamesPtr: number,
+          resultsPtr: number
+        ): void => {
+          this.handleModulePrefetch(
+            rtPtr,
+            ctxPtr,
+            count,
+            baseNamesPtr,
+            moduleNamesPtr,
+            resultsPtr
+          );
+        },
+
         normalize_module: (
           rtPtr: number,
           ctxPtr: number,
@@ -455,11 +512,13 @@ export class CallbackManager {
    */
   private createModuleSourceString(
     ctxPtr: JSContextPointer,
-    sourceCode: string
+    sourceCode: string,
+    version?: string
   ): number {
     // Allocate memory for the HakoModuleSource struct
-    // struct layout: 4 bytes (enum) + 4 bytes (union pointer) = 8 bytes
-    const structSize = 8;
+    // struct layout: 4 bytes (enum) + 4 bytes (union pointer) + 4 bytes
+    // (version pointer) = 12 bytes
+    const structSize = MODULE_SOURCE_SIZE;
     const structPtr = this.exports.HAKO_Malloc(ctxPtr, structSize);
     if (structPtr === 0) {
       return 0;
@@ -472,6 +531,10 @@ export class CallbackManager {
       return 0;
     }
 
+    // The version lets the runtime share the compiled module across contexts
+    const versionPtr =
+      version === undefined ? 0 : this.memory.allocateString(ctxPtr, version);
+
     // Write the struct data
     const exports = this.exports;
     const view = new DataView(exports.memory.buffer);
@@ -482,6 +545,9 @@ export class CallbackManager {
     // Write union data (source_code pointer) at offset 4
     view.setUint32(structPtr + 4, sourcePtr, true);
 
+    // Write version pointer at offset 8
+    view.setUint32(structPtr + 8, versionPtr, true);
+
     return structPtr;
   }
 
@@ -493,7 +559,7 @@ export class CallbackManager {
     moduleDefPtr: number
   ): number {
     // Allocate memory for the HakoModuleSource struct
-    const structSize = 8;
+    const structSize = MODULE_SOURCE_SIZE;
     const structPtr = this.exports.HAKO_Malloc(ctxPtr, structSize);
     if (structPtr === 0) {
       return 0;
@@ -508,6 +574,7 @@ export class CallbackManager {
 
     // Write union data (module_def pointer) at offset 4
     view.setUint32(structPtr + 4, moduleDefPtr, true);
+    view.setUint32(structPtr + 8, 0, true);
 
     return structPtr;
   }
@@ -517,7 +584,7 @@ export class CallbackManager {
    */
   private createModuleSourceError(ctxPtr: JSContextPointer): number {
     // Allocate memory for the HakoModuleSource struct
-    const structSize = 8;
+    const structSize = MODULE_SOURCE_SIZE;
     const structPtr = this.exports.HAKO_Malloc(ctxPtr, structSize);
     if (structPtr === 0) {
       return 0;
@@ -532,6 +599,7 @@ export class CallbackManager {
 
     // Write union data (NULL pointer) at offset 4
     view.setUint32(structPtr + 4, 0, true);
+    view.setUint32(structPtr + 8, 0, true);
 
     return structPtr;
   }
@@ -572,7 +640,11 @@ export class CallbackManager {
       }
       switch (moduleResult.type) {
         case "source":
-          return this.createModuleSourceString(ctxPtr, moduleResult.data);
+          return this.createModuleSourceString(
+            ctxPtr,
+            moduleResult.data,
+            moduleResult.version
+          );
         case "precompiled":
           return this.createModuleSourcePrecompiled(ctxPtr, moduleResult.data);
         default:
@@ -583,6 +655,68 @@ export class CallbackManager {
     }
   }
 
+  /**
+   * Handles a batched module prefetch request from PrimJS.
+   *
+   * Each (base, specifier) pair is normalized and loaded like a regular
+   * import; source results are written to the HakoModulePrefetch array.
+   * Anything else is left empty so the import takes the regular path.
+   */
+  handleModulePrefetch(
+    _rtPtr: JSRuntimePointer,
+    ctxPtr: JSContextPointer,
+    count: number,
+    baseNamesPtr: number,
+    moduleNamesPtr: number,
+    resultsPtr: number
+  ): void {
+    if (!this.moduleLoader) {
+      return;
+    }
+
+    for (let i = 0; i < count; i++) {
+      const baseName = this.memory.readString(
+        this.memory.readUint32(baseNamesPtr + i * 4)
+      );
+      const specifier = this.memory.readString(
+        this.memory.readUint32(moduleNamesPtr + i * 4)
+      );
+
+      try {
+        const name = this.moduleNormalizer
+          ? this.moduleNormalizer(baseName, specifier)
+          : defaultNormalizeModuleName(baseName, specifier);
+        const moduleResult = this.moduleLoader(name);
+        if (moduleResult?.type !== "source") {
+          continue;
+        }
+
+        // HakoModulePrefetch: name, source and version pointers
+        const resultPtr = resultsPtr + i * MODULE_PREFETCH_SIZE;
+        const view = new DataView(this.exports.memory.buffer);
+        view.setUint32(
+          resultPtr,
+          this.memory.allocateString(ctxPtr, name),
+          true
+        );
+        view.setUint32(
+          resultPtr + 4,
+          this.memory.allocateString(ctxPtr, moduleResult.data),
+          true
+        );
+        if (moduleResult.version !== undefined) {
+          view.setUint32(
+            resultPtr + 8,
+            this.memory.allocateString(ctxPtr, moduleResult.version),
+            true
+          );
+        }
+      } catch {
+        // Left to the regular loader, which reports the error
+      }
+    }
+  }
+
   handleModuleResolve(
     _rtPtr: JSRuntimePointer,
     _ctxPtr: JSContextPointer,
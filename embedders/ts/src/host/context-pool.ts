@@ -0,0 +1,153 @@
+import { HakoError } from "../etc/errors";
+import type { ContextOptions } from "../etc/types";
+import type { VMContext } from "../vm/context";
+import type { HakoRuntime } from "./runtime";
+
+/**
+ * Configuration options for {@link HakoRuntime.createContextPool}
+ */
+export interface ContextPoolOptions {
+  /**
+   * Options for the contexts the pool creates
+   */
+  context?: ContextOptions;
+  /**
+   * Idle contexts kept across all keys; the least recently released one is
+   * freed first (default 16)
+   */
+  maxIdle?: number;
+  /**
+   * Runs once in each new context, before its baseline is saved
+   */
+  prelude?: (context: VMContext) => void;
+}
+
+/**
+ * A pool of contexts that are reset and reused instead of created and freed
+ * for every invocation.
+ *
+ * Contexts are acquired for a key, typically a tenant, and only reused for
+ * the same key: {@link VMContext.reset} cannot drop top-level let, const and
+ * class bindings or loaded modules, so those are never seen by another key.
+ * A context is freed instead of reused when resetting it fails or when
+ * pending jobs are left in the runtime.
+ *
+ * @implements {Disposable} - Frees the idle contexts
+ */
+export class ContextPool implements Disposable {
+  private runtime: HakoRuntime;
+  private options: ContextPoolOptions;
+  private maxIdle: number;
+
+  /**
+   * Idle contexts, least recently released first
+   */
+  private idle: Array<{ key: string; context: VMContext }> = [];
+
+  /**
+   * Keys of the contexts handed out by {@link acquire}
+   */
+  private acquired = new Map<VMContext, string>();
+
+  private isReleased = false;
+
+  /**
+   * Creates a new pool. Use {@link HakoRuntime.createContextPool} instead.
+   *
+   * @param runtime - Runtime the contexts are created in
+   * @param options - Pool configuration
+   */
+  constructor(runtime: HakoRuntime, options: ContextPoolOptions = {}) {
+    this.runtime = runtime;
+    this.options = options;
+    this.maxIdle = options.maxIdle ?? 16;
+  }
+
+  /**
+   * Number of idle contexts held by the pool.
+   */
+  get idleCount(): number {
+    return this.idle.length;
+  }
+
+  /**
+   * Takes an idle context last used for the same key, or creates one.
+   *
+   * @param key - Identifies who the context runs code for
+   * @returns A context in its baseline state; hand it back with
+   *          {@link release}
+   * @throws {HakoError} If the pool has been disposed
+   */
+  acquire(key: string): VMContext {
+    if (this.isReleased) {
+      throw new HakoError("Context pool has been disposed");
+    }
+    for (let i = this.idle.length - 1; i >= 0; i--) {
+      if (this.idle[i].key === key) {
+        const { context } = this.idle.splice(i, 1)[0];
+        this.acquired.set(context, key);
+        return context;
+      }
+    }
+
+    const context = this.runtime.createContext(this.options.context);
+    try {
+      this.options.prelude?.(context);
+      context.saveBaseline();
+    } catch (error) {
+      context.release();
+      throw error;
+    }
+    this.acquired.set(context, key);
+    return context;
+  }
+
+  /**
+   * Hands a context back to the pool, which resets it for the next
+   * {@link acquire} with the same key or frees it.
+   *
+   * @param context - Context returned by {@link acquire}
+   * @throws {HakoError} If the context was not acquired from this pool
+   */
+  release(context: VMContext): void {
+    const key = this.acquired.get(context);
+    if (key === undefined) {
+      throw new HakoError("Context was not acquired from this pool");
+    }
+    this.acquired.delete(context);
+
+    if (this.isReleased || this.maxIdle <= 0 || this.runtime.isJobPending()) {
+      context.release();
+      return;
+    }
+    try {
+      context.reset();
+    } catch {
+      context.release();
+      return;
+    }
+    this.idle.push({ key, context });
+    if (this.idle.length > this.maxIdle) {
+      this.idle.shift()?.context.release();
+    }
+  }
+
+  /**
+   * Frees every idle context. Contexts still acquired are freed when they
+   * are released back to the pool.
+   */
+  dispose(): void {
+    this.isReleased = true;
+    for (const { context } of this.idle) {
+      context.release();
+    }
+    this.idle = [];
+  }
+
+  /**
+   * Implements the Symbol.dispose method for the Disposable interface.
+   */
+  [Symbol.dispose](): void {
+    this.dispose();
+  }
+}
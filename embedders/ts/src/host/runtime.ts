@@ -1,3 +1,4 @@
+import { HakoError } from "../etc/errors";
 import {
   type ContextOptions,
   type ExecutePendingJobsResult,
@@ -11,7 +12,9 @@ import {
   type ModuleLoaderFunction,
   type ModuleNormalizerFunction,
   type ModuleResolverFunction,
+  type PinnedByteCode,
   type ProfilerEventHandler,
+  type ScriptCacheStats,
   type StripOptions,
 } from "../etc/types";
 import { DisposableResult, Scope } from "../mem/lifetime";
@@ -19,6 +22,7 @@ import { CModuleBuilder, type CModuleInitializer } from "../vm/cmodule";
 import { VMContext } from "../vm/context";
 import { VMValue } from "../vm/value";
 import type { Container } from "./container";
+import { ContextPool, type ContextPoolOptions } from "./context-pool";
 
 /**
  * The HakoRuntime class represents a JavaScript execution environment.
@@ -60,6 +64,11 @@ export class HakoRuntime implements Disposable {
    */
   private contextMap = new Map<number, VMContext>();
 
+  /**
+   * Encoder for module source passed to {@link registerModule}.
+   */
+  private encoder = new TextEncoder();
+
   /**
    * Reference to the current interrupt handler function.
    * Stored to allow for proper cleanup when the runtime is disposed.
@@ -157,6 +166,62 @@ export class HakoRuntime implements Disposable {
     return context;
   }
 
+  /**
+   * Gets the template context of a module pre-initialized with
+   * tools/preinitialize.ts.
+   *
+   * The context was created and initialized before the module was captured,
+   * so it is ready without running its init script again. Closures, modules
+   * and other heap state built by that script are part of the captured
+   * memory, which makes this the way to skip the cost of a large prelude.
+   *
+   * @returns The template context, or undefined if this runtime was not
+   *          pre-initialized
+   */
+  getPreinitializedContext(): VMContext | undefined {
+    const exports = this.container.exports;
+    const ctxPtr = exports.HAKO_GetPreinitializedContext();
+    if (
+      ctxPtr === 0 ||
+      exports.HAKO_GetPreinitializedRuntime() !== this.rtPtr
+    ) {
+      return undefined;
+    }
+    const existing = this.contextMap.get(ctxPtr);
+    if (existing) {
+      return existing;
+    }
+    const context = new VMContext(this.container, this, ctxPtr);
+    this.contextMap.set(ctxPtr, context);
+    return context;
+  }
+
+  /**
+   * Records this runtime and a template context as the state a
+   * pre-initialized module starts from. Used by tools/preinitialize.ts right
+   * before it captures linear memory.
+   *
+   * @param context - Initialized context of this runtime
+   */
+  markPreinitialized(context: VMContext): void {
+    this.container.exports.HAKO_SetPreinitialized(
+      this.rtPtr,
+      context.pointer
+    );
+  }
+
+  /**
+   * Creates a pool of contexts that are reset and reused per key instead of
+   * created and freed for every invocation.
+   *
+   * @param options - Context options, idle limit and a prelude for new
+   *                  contexts
+   * @returns The pool; dispose it to free its idle contexts
+   */
+  createContextPool(options: ContextPoolOptions = {}): ContextPool {
+    return new ContextPool(this, options);
+  }
+
   /**
    * Sets the stripping options for the runtime
    *
@@ -222,6 +287,49 @@ export class HakoRuntime implements Disposable {
     this.container.exports.HAKO_RuntimeSetMemoryLimit(this.rtPtr, runtimeLimit);
   }
 
+  /**
+   * Sets the size limit of the compiled script cache.
+   *
+   * Non-module scripts evaluated in any context of this runtime are cached as
+   * bytecode, so evaluating the same source again skips parsing and
+   * compilation. Least recently used scripts are evicted past the limit.
+   *
+   * @param bytes - The cache size limit in bytes, or 0 to disable the cache
+   */
+  setScriptCacheLimit(bytes: number): void {
+    this.container.exports.HAKO_SetScriptCacheLimit(this.rtPtr, bytes);
+  }
+
+  /**
+   * Reads the compiled script cache counters.
+   *
+   * @returns Hit, miss and eviction counts along with the current size
+   */
+  getScriptCacheStats(): ScriptCacheStats {
+    const statsPtr = this.allocateMemory(24);
+    try {
+      this.container.exports.HAKO_GetScriptCacheStats(this.rtPtr, statsPtr);
+      const memory = this.container.memory;
+      return {
+        hits: memory.readUint32(statsPtr),
+        misses: memory.readUint32(statsPtr + 4),
+        evictions: memory.readUint32(statsPtr + 8),
+        entries: memory.readUint32(statsPtr + 12),
+        bytes: memory.readUint32(statsPtr + 16),
+        limit: memory.readUint32(statsPtr + 20),
+      };
+    } finally {
+      this.freeMemory(statsPtr);
+    }
+  }
+
+  /**
+   * Drops every script from the compiled script cache.
+   */
+  purgeScriptCache(): void {
+    this.container.exports.HAKO_PurgeScriptCache(this.rtPtr);
+  }
+
   /**
    * Computes detailed memory usage statistics for this runtime.
    *
@@ -336,6 +444,152 @@ export class HakoRuntime implements Disposable {
     this.container.exports.HAKO_RuntimeDisableModuleLoader(this.rtPtr);
   }
 
+  /**
+   * Enables or disables batched prefetch of import graphs.
+   *
+   * With prefetch on, the static imports of each compiled module are passed
+   * to the module loader together, level by level through the import graph,
+   * instead of one host call per import. The loader sees each module name
+   * once; imports with attributes and dynamic imports are loaded as usual.
+   *
+   * @param enabled - Whether to prefetch imports
+   */
+  setModulePrefetch(enabled: boolean): void {
+    this.container.exports.HAKO_RuntimeSetModulePrefetch(
+      this.rtPtr,
+      enabled ? 1 : 0
+    );
+  }
+
+  /**
+   * Drops modules compiled for the runtime-wide module cache.
+   *
+   * Sources returned by the module loader with a version are compiled once
+   * and shared by every context of this runtime until invalidated or
+   * replaced by a different version.
+   *
+   * @param moduleName - Normalized name of the module to drop, or undefined
+   *                     to drop every cached module
+   */
+  invalidateModuleCache(moduleName?: string): void {
+    if (moduleName === undefined) {
+      this.container.exports.HAKO_InvalidateModuleCache(this.rtPtr, 0);
+      return;
+    }
+    const namePtr = this.container.memory.allocateRuntimeString(
+      this.rtPtr,
+      moduleName
+    );
+    try {
+      this.container.exports.HAKO_InvalidateModuleCache(this.rtPtr, namePtr);
+    } finally {
+      this.freeMemory(namePtr);
+    }
+  }
+
+  /**
+   * Registers a bundle of precompiled modules with this runtime.
+   *
+   * Imports that resolve to a module in the bundle are served from it
+   * without calling the module loader; each module is deserialized the first
+   * time it is imported. The module loader must be enabled for imports to
+   * reach the bundle.
+   *
+   * @param bundle - Bundle from encodeByteCodeBundle
+   * @returns The number of modules in the bundle
+   * @throws {HakoError} If the bundle is malformed
+   */
+  loadBundle(bundle: Uint8Array): number {
+    const pointer = this.allocateMemory(Math.max(bundle.byteLength, 1));
+    new Uint8Array(this.container.exports.memory.buffer).set(bundle, pointer);
+
+    // On success the runtime owns the buffer
+    const count = this.container.exports.HAKO_LoadBundle(
+      this.rtPtr,
+      pointer,
+      bundle.byteLength
+    );
+    if (count < 0) {
+      this.freeMemory(pointer);
+      throw new HakoError("Malformed bytecode bundle");
+    }
+    return count;
+  }
+
+  /**
+   * Releases every bundle registered with {@link loadBundle}.
+   *
+   * Modules that were already imported stay loaded in their contexts.
+   */
+  unloadBundles(): void {
+    this.container.exports.HAKO_UnloadBundles(this.rtPtr);
+  }
+
+  /**
+   * Registers a module with this runtime so that imports of its name are
+   * served by the bridge itself, before any bundle or the module loader.
+   *
+   * Source modules are compiled the first time they are imported and the
+   * result is shared by every context of this runtime. Registering a name
+   * again replaces the previous module.
+   *
+   * @param moduleName - Normalized module name
+   * @param module - Module source code, or bytecode from
+   *                 {@link VMContext.compileToByteCode}
+   * @throws {HakoError} If the module could not be registered
+   */
+  registerModule(moduleName: string, module: string | Uint8Array): void {
+    const isByteCode = module instanceof Uint8Array;
+    const bytes = isByteCode ? module : this.encoder.encode(module);
+    const namePtr = this.container.memory.allocateRuntimeString(
+      this.rtPtr,
+      moduleName
+    );
+    const pointer = this.allocateMemory(Math.max(bytes.byteLength, 1));
+    try {
+      new Uint8Array(this.container.exports.memory.buffer).set(bytes, pointer);
+      const exports = this.container.exports;
+      const status = isByteCode
+        ? exports.HAKO_RegisterModuleBytecode(
+            this.rtPtr,
+            namePtr,
+            pointer,
+            bytes.byteLength
+          )
+        : exports.HAKO_RegisterModuleSource(
+            this.rtPtr,
+            namePtr,
+            pointer,
+            bytes.byteLength
+          );
+      if (status < 0) {
+        throw new HakoError(`Failed to register module '${moduleName}'`);
+      }
+    } finally {
+      this.freeMemory(pointer);
+      this.freeMemory(namePtr);
+    }
+  }
+
+  /**
+   * Removes a module registered with {@link registerModule}.
+   *
+   * Contexts that already imported the module keep their instance.
+   *
+   * @param moduleName - Name the module was registered under
+   */
+  unregisterModule(moduleName: string): void {
+    const namePtr = this.container.memory.allocateRuntimeString(
+      this.rtPtr,
+      moduleName
+    );
+    try {
+      this.container.exports.HAKO_UnregisterModule(this.rtPtr, namePtr);
+    } finally {
+      this.freeMemory(namePtr);
+    }
+  }
+
   /**
    * Enables the interrupt handler for this runtime.
    *
@@ -583,6 +837,42 @@ export class HakoRuntime implements Disposable {
     return this.container.memory.allocateRuntimeMemory(this.pointer, size);
   }
 
+  /**
+   * Copies bytecode into the WebAssembly heap once so that any context of
+   * this runtime can evaluate it repeatedly with
+   * {@link VMContext.evalByteCode} without copying it in every time.
+   *
+   * This only saves the copy. Every evaluation still rebuilds the atoms,
+   * constant pools and function bytecode from the buffer, so pinning does
+   * not reduce the memory each context uses.
+   *
+   * @param bytecode - Bytecode from {@link VMContext.compileToByteCode}
+   * @returns The pinned bytecode; dispose it once it is no longer evaluated
+   */
+  pinByteCode(bytecode: Uint8Array): PinnedByteCode {
+    const length = bytecode.byteLength;
+    const pointer = this.allocateMemory(Math.max(length, 1));
+    new Uint8Array(this.container.exports.memory.buffer).set(bytecode, pointer);
+
+    const rt = this.pointer;
+    const memory = this.container.memory;
+    const pinned: PinnedByteCode = {
+      pointer,
+      length,
+      alive: true,
+      dispose() {
+        if (pinned.alive) {
+          pinned.alive = false;
+          memory.freeRuntimeMemory(rt, pointer);
+        }
+      },
+      [Symbol.dispose]() {
+        pinned.dispose();
+      },
+    };
+    return pinned;
+  }
+
   /**
    * Frees previously allocated shared runtime memory.
    * @param ptr - The pointer to the memory to free
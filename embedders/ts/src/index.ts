@@ -191,8 +191,10 @@ export async function createHakoRuntime<TOptions, TResponse>(
   // Create the service container with all dependencies
   const container = new Container(exports, memory, callbacks);
 
-  // Create and return the runtime directly
-  const rtPtr = container.exports.HAKO_NewRuntime();
+  // A pre-initialized module already holds a runtime in its memory image
+  const rtPtr =
+    container.exports.HAKO_GetPreinitializedRuntime() ||
+    container.exports.HAKO_NewRuntime();
   if (rtPtr === 0) {
     throw new HakoError("Failed to create runtime");
   }
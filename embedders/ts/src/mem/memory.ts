@@ -8,11 +8,14 @@
  */
 
 import type { HakoExports } from "../etc/ffi";
-import type {
-  CString,
-  JSContextPointer,
-  JSRuntimePointer,
-  JSValuePointer,
+import {
+  type CString,
+  type JSContextPointer,
+  type JSRuntimePointer,
+  type JSValueConstPointer,
+  type JSValuePointer,
+  type JSValueRaw,
+  LEPUS_VALUE_SIZE,
 } from "../etc/types";
 
 /**
@@ -43,6 +46,12 @@ export class MemoryManager {
    */
   private decoder = new TextDecoder();
 
+  /**
+   * TextDecoder instance for converting UTF-16 code units to JavaScript strings.
+   * @private
+   */
+  private utf16Decoder = new TextDecoder("utf-16le");
+
   /**
    * Sets the WebAssembly exports object after module instantiation.
    * This must be called before any other MemoryManager methods.
@@ -150,6 +159,44 @@ export class MemoryManager {
     return ptr;
   }
 
+  /**
+   * Allocates a null-terminated UTF-8 copy of a string in runtime memory.
+   *
+   * @param str - JavaScript string to convert to a C string
+   * @returns Pointer to the C string; free it with freeRuntimeMemory
+   */
+  allocateRuntimeString(rt: JSRuntimePointer, str: string): CString {
+    const exports = this.checkExports();
+    const bytes = this.encoder.encode(str);
+    const ptr = this.allocateRuntimeMemory(rt, bytes.byteLength + 1);
+    const memory = new Uint8Array(exports.memory.buffer);
+    memory.set(bytes, ptr);
+    memory[ptr + bytes.length] = 0; // Null terminator
+    return ptr;
+  }
+
+  /**
+   * Encodes a string as UTF-8 directly into the WebAssembly heap.
+   *
+   * No null terminator is written; pass the returned length to the
+   * length-aware string exports.
+   *
+   * @param str - JavaScript string to encode
+   * @returns Pointer to the bytes and their length
+   */
+  writeUtf8(
+    ctx: JSContextPointer,
+    str: string
+  ): { pointer: number; length: number } {
+    const exports = this.checkExports();
+    // UTF-8 never takes more than three bytes per UTF-16 code unit
+    const capacity = str.length * 3;
+    const ptr = this.allocateMemory(ctx, Math.max(capacity, 1));
+    const memory = new Uint8Array(exports.memory.buffer, ptr, capacity);
+    const { written } = this.encoder.encodeInto(str, memory);
+    return { pointer: ptr, length: written };
+  }
+
   copy(offset: number, length: number): Uint8Array {
     const exports = this.checkExports();
     const memory = new Uint8Array(exports.memory.buffer);
@@ -175,6 +222,55 @@ export class MemoryManager {
     return { pointer: ptr, length: bytes.length + 1 };
   }
 
+  /**
+   * Decodes UTF-8 bytes of a known length from WebAssembly memory.
+   *
+   * @param ptr - Pointer to the bytes
+   * @param length - Length in bytes
+   * @returns The decoded string
+   */
+  readUtf8(ptr: number, length: number): string {
+    const exports = this.checkExports();
+    return this.decoder.decode(
+      new Uint8Array(exports.memory.buffer, ptr, length)
+    );
+  }
+
+  /**
+   * Decodes Latin-1 characters of a known length from WebAssembly memory.
+   *
+   * @param ptr - Pointer to the characters
+   * @param length - Length in characters
+   * @returns The decoded string
+   */
+  readLatin1(ptr: number, length: number): string {
+    const exports = this.checkExports();
+    const chars = new Uint8Array(exports.memory.buffer, ptr, length);
+    // TextDecoder's "latin1" is windows-1252, which remaps 0x80-0x9f
+    let str = "";
+    for (let i = 0; i < length; i += 4096) {
+      str += String.fromCharCode.apply(
+        null,
+        chars.subarray(i, i + 4096) as unknown as number[]
+      );
+    }
+    return str;
+  }
+
+  /**
+   * Decodes UTF-16 code units of a known length from WebAssembly memory.
+   *
+   * @param ptr - Pointer to the code units, 2-byte aligned
+   * @param length - Length in code units
+   * @returns The decoded string
+   */
+  readUtf16(ptr: number, length: number): string {
+    const exports = this.checkExports();
+    return this.utf16Decoder.decode(
+      new Uint16Array(exports.memory.buffer, ptr, length)
+    );
+  }
+
   /**
    * Reads a null-terminated C string from the WebAssembly heap.
    *
@@ -306,6 +402,43 @@ export class MemoryManager {
     return ptr;
   }
 
+  /**
+   * Copies the values behind a list of value pointers into a contiguous
+   * LEPUSValue array, as taken by HAKO_CallArgv and friends.
+   *
+   * @param arrayPtr - Pointer to an array with room for values.length entries
+   * @param values - Pointers to the values to copy (borrowed, not duplicated)
+   */
+  writeValueArray(arrayPtr: number, values: JSValueConstPointer[]): void {
+    const exports = this.checkExports();
+    const memory = new Uint8Array(exports.memory.buffer);
+    for (let i = 0; i < values.length; i++) {
+      const ptr = values[i];
+      memory.copyWithin(
+        arrayPtr + i * LEPUS_VALUE_SIZE,
+        ptr,
+        ptr + LEPUS_VALUE_SIZE
+      );
+    }
+  }
+
+  /**
+   * Writes a raw value into a contiguous LEPUSValue array.
+   *
+   * @param arrayPtr - Pointer to the array
+   * @param index - Index in the array to write to
+   * @param value - Raw value to write
+   */
+  writeRawValueToArray(
+    arrayPtr: number,
+    index: number,
+    value: JSValueRaw
+  ): void {
+    const exports = this.checkExports();
+    const view = new DataView(exports.memory.buffer);
+    view.setBigUint64(arrayPtr + index * LEPUS_VALUE_SIZE, value, true);
+  }
+
   /**
    * Reads a pointer value from an array of pointers.
    *
@@ -7,12 +7,16 @@
 
 import { HakoError } from "../etc/errors";
 import {
+  ATOM_CACHE_LIMIT,
   type ContextEvalOptions,
   type CString,
+  type EvalBuffer,
   evalOptionsToFlags,
   type HostCallbackFunction,
+  type JSAtom,
   type JSContextPointer,
   type JSValuePointer,
+  type PinnedByteCode,
   type PromiseExecutor,
   type VMContextResult,
 } from "../etc/types";
@@ -90,6 +94,24 @@ export class VMContext implements Disposable {
 
   private opaqueDataPointer: CString | undefined = undefined;
 
+  /**
+   * Owned values created inside each open native value scope, innermost last
+   * @private
+   */
+  private valueScopes: Set<VMValue>[] = [];
+
+  /**
+   * Interned property name atoms, freed when the context is released
+   * @private
+   */
+  private atoms = new Map<string, JSAtom>();
+
+  /**
+   * Lazily allocated out-parameter cell, see {@link scratchCell}
+   * @private
+   */
+  private scratchPointer = 0;
+
   /**
    * Creates a new VMContext instance.
    *
@@ -206,6 +228,49 @@ export class VMContext implements Disposable {
     }
   }
 
+  /**
+   * Records the current global object as the state that {@link reset}
+   * returns this context to.
+   *
+   * Call it right after creating the context, or after a prelude that every
+   * later user of the context should see.
+   *
+   * @throws If the global object could not be recorded
+   */
+  saveBaseline(): void {
+    if (this.container.exports.HAKO_SaveContextBaseline(this.ctxPtr) < 0) {
+      throw (
+        this.getLastError() ??
+        new HakoError("Failed to save context baseline")
+      );
+    }
+  }
+
+  /**
+   * Returns this context to the baseline recorded by {@link saveBaseline}
+   * so that it can be reused instead of released.
+   *
+   * Global properties added since the baseline are deleted and reassigned
+   * baseline globals are restored. The opaque data set with
+   * {@link setOpaqueData} is freed here rather than by the bridge. Intrinsic
+   * objects are kept with any changes made to them. Top-level let, const
+   * and class bindings, loaded modules and pending jobs stay in the context,
+   * so a context that ran untrusted code should only be reused for the same
+   * tenant, as {@link HakoRuntime.createContextPool} does.
+   *
+   * @returns The number of global properties that could not be removed or
+   *          restored, such as top-level var and function declarations
+   * @throws If no baseline was saved or a global could not be restored
+   */
+  reset(): number {
+    this.freeOpaqueData();
+    const leftover = this.container.exports.HAKO_ResetContext(this.ctxPtr);
+    if (leftover < 0) {
+      throw this.getLastError() ?? new HakoError("Failed to reset context");
+    }
+    return leftover;
+  }
+
   /**
    * Evaluates JavaScript code in this context.
    *
@@ -276,6 +341,198 @@ export class VMContext implements Disposable {
     }
   }
 
+  /**
+   * Buffers a source that arrives in chunks, such as a large script read
+   * from storage, and evaluates it once it is complete.
+   *
+   * Chunks are copied into one buffer inside the WebAssembly heap as they
+   * are appended, so the whole source never has to be joined into a single
+   * JavaScript string first. Nothing is parsed until {@link EvalBuffer.end},
+   * which behaves like {@link evalCode} on the whole source: compilation
+   * does not overlap with reading, and the complete source is held in
+   * memory.
+   *
+   * @param sizeHint - Expected source size in bytes, if known; an exact
+   *                   hint avoids regrowing the buffer
+   * @returns The buffer; abort or dispose it if it is never ended
+   */
+  createEvalBuffer(sizeHint = 0): EvalBuffer {
+    const exports = this.container.exports;
+    const memory = this.container.memory;
+    const ctxPtr = this.ctxPtr;
+    const bufferPtr = exports.HAKO_EvalBufferBegin(ctxPtr, sizeHint);
+    if (bufferPtr === 0) {
+      throw new HakoError("Failed to allocate eval buffer");
+    }
+
+    const checkAlive = () => {
+      if (!buffer.alive) {
+        throw new HakoError("Eval buffer has already been released");
+      }
+    };
+    const buffer: EvalBuffer = {
+      alive: true,
+      append: (chunk) => {
+        checkAlive();
+        if (chunk.length === 0) {
+          return;
+        }
+        let pointer: number;
+        let length: number;
+        if (typeof chunk === "string") {
+          const written = memory.writeNullTerminatedString(ctxPtr, chunk);
+          pointer = written.pointer;
+          length = written.length - 1;
+        } else {
+          pointer = memory.writeBytes(ctxPtr, chunk);
+          length = chunk.byteLength;
+        }
+        try {
+          if (exports.HAKO_EvalBufferAppend(bufferPtr, pointer, length) < 0) {
+            throw new HakoError("Failed to append to eval buffer");
+          }
+        } finally {
+          memory.freeMemory(ctxPtr, pointer);
+        }
+      },
+      end: (options = {}) => {
+        checkAlive();
+        buffer.alive = false;
+        let fileName = options.fileName || "file://eval";
+        if (!fileName.startsWith("file://")) {
+          fileName = `file://${fileName}`;
+        }
+        const filenamePtr = memory.allocateString(ctxPtr, fileName);
+        try {
+          const resultPtr = exports.HAKO_EvalBufferEnd(
+            bufferPtr,
+            filenamePtr,
+            options.detectModule ? 1 : 0,
+            evalOptionsToFlags(options)
+          );
+          const exceptionPtr = this.container.error.getLastErrorPointer(
+            ctxPtr,
+            resultPtr
+          );
+          if (exceptionPtr !== 0) {
+            memory.freeValuePointer(ctxPtr, resultPtr);
+            return DisposableResult.fail(
+              new VMValue(this, exceptionPtr, "owned"),
+              (error) => this.unwrapResult(error)
+            );
+          }
+          return DisposableResult.success(
+            new VMValue(this, resultPtr, "owned")
+          );
+        } finally {
+          memory.freeMemory(ctxPtr, filenamePtr);
+        }
+      },
+      abort: () => {
+        if (buffer.alive) {
+          buffer.alive = false;
+          exports.HAKO_EvalBufferAbort(bufferPtr);
+        }
+      },
+      [Symbol.dispose]() {
+        buffer.abort();
+      },
+    };
+    return buffer;
+  }
+
+  /**
+   * Compiles a script once so it can be run many times with
+   * {@link runPrepared}.
+   *
+   * Unlike {@link compileToByteCode}, the compiled function stays inside the
+   * VM, so running it skips both parsing and deserialization. Modules cannot
+   * be prepared.
+   *
+   * @param code - JavaScript source of the script
+   * @param options - fileName and strict are honored
+   * @returns Result containing either the prepared script or a syntax error
+   */
+  prepareScript(
+    code: string,
+    options: ContextEvalOptions = {}
+  ): VMContextResult<VMValue> {
+    const codemem = this.container.memory.writeNullTerminatedString(
+      this.ctxPtr,
+      code
+    );
+    let fileName = options.fileName || "file://eval";
+    if (!fileName.startsWith("file://")) {
+      fileName = `file://${fileName}`;
+    }
+    const filenamePtr = this.container.memory.allocateString(
+      this.ctxPtr,
+      fileName
+    );
+
+    try {
+      const resultPtr = this.container.exports.HAKO_PrepareScript(
+        this.ctxPtr,
+        codemem.pointer,
+        codemem.length,
+        filenamePtr,
+        evalOptionsToFlags(options)
+      );
+
+      const exceptionPtr = this.container.error.getLastErrorPointer(
+        this.ctxPtr,
+        resultPtr
+      );
+
+      if (exceptionPtr !== 0) {
+        this.container.memory.freeValuePointer(this.ctxPtr, resultPtr);
+        return DisposableResult.fail(
+          new VMValue(this, exceptionPtr, "owned"),
+          (error) => this.unwrapResult(error)
+        );
+      }
+
+      return DisposableResult.success(
+        new VMValue(this, resultPtr, "owned")
+      );
+    } finally {
+      this.container.memory.freeMemory(this.ctxPtr, codemem.pointer);
+      this.container.memory.freeMemory(this.ctxPtr, filenamePtr);
+    }
+  }
+
+  /**
+   * Runs a script returned by {@link prepareScript}.
+   *
+   * @param prepared - The prepared script
+   * @param thisArg - Value of `this` for the script (default: global object)
+   * @returns Result containing either the completion value or an error
+   */
+  runPrepared(prepared: VMValue, thisArg?: VMValue): VMContextResult<VMValue> {
+    const resultPtr = this.container.exports.HAKO_RunPrepared(
+      this.ctxPtr,
+      prepared.getHandle(),
+      thisArg ? thisArg.getHandle() : 0
+    );
+
+    const exceptionPtr = this.container.error.getLastErrorPointer(
+      this.ctxPtr,
+      resultPtr
+    );
+
+    if (exceptionPtr !== 0) {
+      this.container.memory.freeValuePointer(this.ctxPtr, resultPtr);
+      return DisposableResult.fail(
+        new VMValue(this, exceptionPtr, "owned"),
+        (error) => this.unwrapResult(error)
+      );
+    }
+
+    return DisposableResult.success(
+      new VMValue(this, resultPtr, "owned")
+    );
+  }
+
   /**
    * Compiles JavaScript code to portable bytecode.
    *
@@ -368,26 +625,37 @@ export class VMContext implements Disposable {
   /**
    * Evaluates precompiled JavaScript bytecode.
    *
-   * @param bytecode - Bytecode buffer from compileToByteCode
+   * Bytecode pinned with {@link HakoRuntime.pinByteCode} is passed without
+   * copying; a plain buffer is copied into WebAssembly memory for each call.
+   * Either way the bytecode is deserialized into new objects.
+   *
+   * @param bytecode - Bytecode buffer from compileToByteCode, or pinned bytecode
    * @param options - loadOnly: Only load bytecode without executing
    * @returns Evaluation result or error
    */
   evalByteCode(
-    bytecode: Uint8Array,
+    bytecode: Uint8Array | PinnedByteCode,
     options: { loadOnly?: boolean } = {}
   ): VMContextResult<VMValue> {
     if (bytecode.length === 0) {
       return DisposableResult.success(this.undefined());
     }
 
+    const pinned = !(bytecode instanceof Uint8Array);
+    if (pinned && !bytecode.alive) {
+      throw new HakoError("Pinned bytecode has been disposed");
+    }
+
     // Allocate memory for the bytecode in WASM
-    const bytecodePtr = this.container.memory.writeBytes(this.ctxPtr, bytecode);
+    const bytecodePtr = pinned
+      ? bytecode.pointer
+      : this.container.memory.writeBytes(this.ctxPtr, bytecode);
 
     try {
       const resultPtr = this.container.exports.HAKO_EvalByteCode(
         this.ctxPtr,
         bytecodePtr,
-        bytecode.byteLength,
+        bytecode.length,
         options.loadOnly ? 1 : 0
       );
 
@@ -409,7 +677,9 @@ export class VMContext implements Disposable {
         new VMValue(this, resultPtr, "owned")
       );
     } finally {
-      this.container.memory.freeMemory(this.ctxPtr, bytecodePtr);
+      if (!pinned) {
+        this.container.memory.freeMemory(this.ctxPtr, bytecodePtr);
+      }
     }
   }
 
@@ -462,32 +732,58 @@ export class VMContext implements Disposable {
       }
       const thisPtr = thisArg.getHandle();
 
-      let argvPtr: number = 0;
-
-      if (args.length > 0) {
-        argvPtr = this.container.memory.allocatePointerArray(
+      // Arguments are copied by value into the context scratch argv, so a
+      // call needs no allocation on either side of the boundary
+      const argvPtr =
+        args.length > 0
+          ? this.container.exports.HAKO_GetScratchArgv(
+              this.pointer,
+              args.length
+            )
+          : 0;
+
+      let resultPtr: JSValuePointer;
+      if (args.length === 0 || argvPtr !== 0) {
+        if (argvPtr !== 0) {
+          this.container.memory.writeValueArray(
+            argvPtr,
+            args.map((arg) => arg.getHandle())
+          );
+        }
+        // A NULL argv tells the bridge to take the arguments from the scratch
+        // buffer, which it copies so re-entrant calls can reuse it
+        resultPtr = this.container.exports.HAKO_CallArgv(
+          this.pointer,
+          func.getHandle(),
+          thisPtr,
+          args.length,
+          0
+        );
+      } else {
+        // Too many arguments for the scratch argv; pass value pointers instead
+        const argvPtrs = this.container.memory.allocatePointerArray(
           this.ctxPtr,
           args.length
         );
-        scope.add(() => this.container.memory.freeMemory(this.ctxPtr, argvPtr));
-
+        scope.add(() =>
+          this.container.memory.freeMemory(this.ctxPtr, argvPtrs)
+        );
         for (let i = 0; i < args.length; i++) {
           this.container.memory.writePointerToArray(
-            argvPtr,
+            argvPtrs,
             i,
             args[i].getHandle()
           );
         }
+        resultPtr = this.container.exports.HAKO_Call(
+          this.pointer,
+          func.getHandle(),
+          thisPtr,
+          args.length,
+          argvPtrs
+        );
       }
 
-      const resultPtr = this.container.exports.HAKO_Call(
-        this.pointer,
-        func.getHandle(),
-        thisPtr,
-        args.length,
-        argvPtr
-      );
-
       const exceptionPtr = this.container.error.getLastErrorPointer(
         this.pointer,
         resultPtr
@@ -1018,6 +1314,151 @@ export class VMContext implements Disposable {
     return new VMValue(this, duped, "owned");
   }
 
+  /**
+   * Executes a function within a native value scope.
+   *
+   * Every owned value created while the block runs is recorded by the VM and
+   * freed in a single call when the block returns. Disposing such a value
+   * inside the block does not cross into the VM at all. Values that must
+   * outlive the block have to be passed to {@link promoteValue} first.
+   *
+   * @template T - The return type of the function
+   * @param block - The function to execute within the value scope
+   * @returns The result of the function
+   */
+  withValueScope<T>(block: (scope: Scope) => T): T {
+    const exports = this.container.exports;
+    const scopeId = exports.HAKO_PushValueScope(this.ctxPtr);
+    if (scopeId === 0) {
+      return Scope.withScope(block);
+    }
+
+    const values = new Set<VMValue>();
+    this.valueScopes.push(values);
+    try {
+      return Scope.withScope(block);
+    } finally {
+      this.valueScopes.pop();
+      for (const value of values) {
+        value.detachFromValueScope();
+      }
+      exports.HAKO_PopValueScope(this.ctxPtr, scopeId);
+    }
+  }
+
+  /**
+   * Moves a value out of the innermost value scope it belongs to, so it
+   * survives that scope being closed.
+   *
+   * @param value - The value to promote
+   * @returns The same value, allowing for chained method calls
+   */
+  promoteValue(value: VMValue): VMValue {
+    const index = this.valueScopes.findIndex((scope) => scope.has(value));
+    if (index === -1) {
+      return value;
+    }
+    this.container.exports.HAKO_PromoteValue(this.ctxPtr, value.getHandle());
+    this.valueScopes[index].delete(value);
+    const parent = index > 0 ? this.valueScopes[index - 1] : undefined;
+    parent?.add(value);
+    value.moveToValueScope(parent);
+    return value;
+  }
+
+  /**
+   * Gets the innermost open native value scope, if any.
+   *
+   * @returns The set of values tracked by the innermost scope
+   * @internal
+   */
+  currentValueScope(): Set<VMValue> | undefined {
+    return this.valueScopes[this.valueScopes.length - 1];
+  }
+
+  /**
+   * Executes a function with the atom for a property name.
+   *
+   * Atoms are interned per context, so repeated accesses to the same property
+   * name skip creating a key string and hashing it. Once
+   * {@link ATOM_CACHE_LIMIT} names are cached, further names get a temporary
+   * atom that is freed when the function returns.
+   *
+   * @template T - The return type of the function
+   * @param name - The property name
+   * @param fn - The function to execute with the atom
+   * @returns The result of the function
+   * @internal
+   */
+  withAtom<T>(name: string, fn: (atom: JSAtom) => T): T {
+    const cached = this.atoms.get(name);
+    if (cached !== undefined) {
+      return fn(cached);
+    }
+    return this.withAtoms([name], (atoms) => fn(atoms[0]));
+  }
+
+  /**
+   * Executes a function with the atoms for several property names.
+   *
+   * @template T - The return type of the function
+   * @param names - The property names
+   * @param fn - The function to execute with the atoms, in the same order
+   * @returns The result of the function
+   * @internal
+   */
+  withAtoms<T>(names: readonly string[], fn: (atoms: JSAtom[]) => T): T {
+    const exports = this.container.exports;
+    const atoms: JSAtom[] = new Array(names.length);
+    const temporary: JSAtom[] = [];
+    try {
+      for (let i = 0; i < names.length; i++) {
+        const cached = this.atoms.get(names[i]);
+        if (cached !== undefined) {
+          atoms[i] = cached;
+          continue;
+        }
+        const atom = this.newAtom(names[i]);
+        if (this.atoms.size < ATOM_CACHE_LIMIT) {
+          this.atoms.set(names[i], atom);
+        } else {
+          temporary.push(atom);
+        }
+        atoms[i] = atom;
+      }
+      return fn(atoms);
+    } finally {
+      for (const atom of temporary) {
+        exports.HAKO_FreeAtom(this.ctxPtr, atom);
+      }
+    }
+  }
+
+  /**
+   * Interns a property name as a new atom reference.
+   *
+   * @param name - The property name
+   * @returns The atom, which must be freed with HAKO_FreeAtom
+   * @private
+   */
+  private newAtom(name: string): JSAtom {
+    const memory = this.container.memory;
+    const { pointer, length } = memory.writeNullTerminatedString(
+      this.ctxPtr,
+      name
+    );
+    const atom = this.container.exports.HAKO_NewAtom(
+      this.ctxPtr,
+      pointer,
+      length - 1
+    );
+    memory.freeMemory(this.ctxPtr, pointer);
+    if (atom === 0) {
+      throw new HakoError(`Failed to create atom for "${name}"`);
+    }
+    return atom;
+  }
+
   /**
    * Converts a JavaScript value to a VM value.
    *
@@ -1103,6 +1544,24 @@ export class VMContext implements Disposable {
     });
   }
 
+  /**
+   * Gets an 8-byte cell for out-parameters of exports that cannot call back
+   * into the host, so they need no allocation of their own.
+   *
+   * The cell is shared; read it right after the call that fills it.
+   *
+   * @returns Pointer to the cell
+   */
+  scratchCell(): number {
+    if (this.scratchPointer === 0) {
+      this.scratchPointer = this.container.memory.allocateMemory(
+        this.ctxPtr,
+        8
+      );
+    }
+    return this.scratchPointer;
+  }
+
   /**
    * Releases all resources associated with this context.
    *
@@ -1114,6 +1573,12 @@ export class VMContext implements Disposable {
       this._Symbol?.dispose();
       this._SymbolAsyncIterator?.dispose();
       this._SymbolIterator?.dispose();
+      for (const atom of this.atoms.values()) {
+        this.container.exports.HAKO_FreeAtom(this.ctxPtr, atom);
+      }
+      this.atoms.clear();
+      this.container.memory.freeMemory(this.ctxPtr, this.scratchPointer);
+      this.scratchPointer = 0;
       // Unregister from the callback manager
       this.container.callbacks.unregisterContext(this.ctxPtr);
       // Free the context
@@ -3,7 +3,9 @@ import {
   detectCircularReferences,
   type HostCallbackFunction,
 } from "../etc/types";
+import { encodeNativeGraph } from "../helpers/native-graph";
 import type { Container } from "../host/container";
+import { Scope } from "../mem/lifetime";
 import type { VMContext } from "./context";
 import { VMValue } from "./value";
 
@@ -283,15 +285,16 @@ export class ValueFactory implements Disposable {
    * @private
    */
   private createString(value: string): VMValue {
-    const strPtr = this.container.memory.allocateString(
+    const { pointer, length } = this.container.memory.writeUtf8(
       this.context.pointer,
       value
     );
-    const jsStrPtr = this.container.exports.HAKO_NewString(
+    const jsStrPtr = this.container.exports.HAKO_NewStringLen(
       this.context.pointer,
-      strPtr
+      pointer,
+      length
     );
-    this.container.memory.freeMemory(this.context.pointer, strPtr);
+    this.container.memory.freeMemory(this.context.pointer, pointer);
     return new VMValue(this.context, jsStrPtr, "owned");
   }
 
@@ -369,21 +372,11 @@ export class ValueFactory implements Disposable {
    *
    * @param value - The JavaScript array
    * @returns A VM Array value
+   * @throws TypeError if circular references are detected
    * @private
    */
   private createArray(value: unknown[]): VMValue {
-    // Create array and populate it
-    const arrayPtr = this.container.exports.HAKO_NewArray(this.context.pointer);
-    const jsArray = new VMValue(this.context, arrayPtr, "owned");
-
-    for (let i = 0; i < value.length; i++) {
-      using item = this.fromNativeValue(value[i]);
-      if (item) {
-        jsArray.setProperty(i, item);
-      }
-    }
-
-    return jsArray;
+    return this.createGraph(value);
   }
 
   /**
@@ -452,17 +445,17 @@ export class ValueFactory implements Disposable {
     value: Record<string, unknown>,
     options: Record<string, unknown>
   ): VMValue {
+    if (!(options.proto instanceof VMValue)) {
+      return this.createGraph(value);
+    }
+
     // Check for circular references which can't be represented in the VM
     detectCircularReferences(value);
 
-    // General object case
-    const objPtr =
-      options.proto && options.proto instanceof VMValue
-        ? this.container.exports.HAKO_NewObjectProto(
-            this.context.pointer,
-            options.proto.getHandle()
-          )
-        : this.container.exports.HAKO_NewObject(this.context.pointer);
+    const objPtr = this.container.exports.HAKO_NewObjectProto(
+      this.context.pointer,
+      options.proto.getHandle()
+    );
 
     const lastError = this.context.getLastError(objPtr);
     if (lastError) {
@@ -472,19 +465,61 @@ export class ValueFactory implements Disposable {
 
     using jsObj = new VMValue(this.context, objPtr, "owned");
 
-    // Add all properties from the source object
-    for (const key in value) {
-      if (Object.hasOwn(value, key)) {
-        using propValue = this.fromNativeValue(value[key]);
-        if (propValue) {
-          jsObj.setProperty(key, propValue);
-        }
-      }
-    }
+    // Add all properties from the source object in a single call
+    jsObj.setProperties(value);
 
     return jsObj.dup();
   }
 
+  /**
+   * Creates a VM array or object graph in a single call.
+   *
+   * Plain arrays and objects are encoded as data and built inside the VM by
+   * HAKO_FromNative. Other values are converted on their own and passed by
+   * pointer.
+   *
+   * @param value - The JavaScript array or object
+   * @returns A VM value for the root of the graph
+   * @throws TypeError if circular references are detected
+   * @private
+   */
+  private createGraph(value: object): VMValue {
+    return Scope.withScope((scope) => {
+      const ctx = this.context.pointer;
+      const bytes = encodeNativeGraph(value, (item) => {
+        if (item instanceof VMValue) {
+          return item.getHandle();
+        }
+        if (
+          typeof item === "object" &&
+          !(item instanceof Date) &&
+          !(item instanceof Error) &&
+          !(item instanceof ArrayBuffer) &&
+          !ArrayBuffer.isView(item)
+        ) {
+          return undefined;
+        }
+        return scope.manage(this.fromNativeValue(item)).getHandle();
+      });
+
+      const dataPtr = this.container.memory.writeBytes(ctx, bytes);
+      scope.add(() => this.container.memory.freeMemory(ctx, dataPtr));
+      const valuePtr = this.container.exports.HAKO_FromNative(
+        ctx,
+        dataPtr,
+        bytes.byteLength,
+        0
+      );
+
+      const lastError = this.context.getLastError(valuePtr);
+      if (lastError) {
+        this.container.memory.freeValuePointer(ctx, valuePtr);
+        throw lastError;
+      }
+      return new VMValue(this.context, valuePtr, "owned");
+    });
+  }
+
   /**
    * Gets the global object from the VM context.
    *
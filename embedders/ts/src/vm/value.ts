@@ -4,14 +4,22 @@ import {
   type EqualOp,
   type JSType,
   type JSValuePointer,
+  type JSValueRaw,
   LEPUS_BOOLToBoolean,
+  LEPUS_VALUE_SIZE,
+  NATIVE_FLAG_REJECT_CYCLES,
+  type NativeGraphOptions,
+  PACK_KEY_UTF8,
+  PACKED_KEY_INDEX,
   PROPERTY_ENUM_ENUMERABLE,
   PROPERTY_ENUM_STRING,
+  PROPERTY_ENUM_SYMBOL,
   type PromiseState,
   type PropertyEnumFlags,
   type TypedArrayType,
   type ValueLifecycle,
 } from "../etc/types";
+import { decodeNativeGraph } from "../helpers/native-graph";
 import { type NativeBox, Scope } from "../mem/lifetime";
 import type { VMContext } from "./context";
 
@@ -44,6 +52,12 @@ export class VMValue implements Disposable {
    */
   private lifecycle: ValueLifecycle;
 
+  /**
+   * Native value scope that will free this value, if it was created in one
+   * @private
+   */
+  private valueScope: Set<VMValue> | undefined;
+
   /**
    * Creates a new VMValue instance.
    *
@@ -59,6 +73,10 @@ export class VMValue implements Disposable {
     this.context = context;
     this.handle = handle;
     this.lifecycle = lifecycle;
+    if (lifecycle !== "borrowed") {
+      this.valueScope = context.currentValueScope();
+      this.valueScope?.add(this);
+    }
   }
 
   /**
@@ -484,6 +502,21 @@ export class VMValue implements Disposable {
    */
   asString(): string {
     this.assertAlive();
+    const { exports, memory } = this.context.container;
+    // Reading a string never re-enters the host, so the shared cell is safe.
+    // It receives a HakoStringView: length, then 1 for UTF-16 characters.
+    const viewPtr = this.context.scratchCell();
+    const charsPtr = exports.HAKO_GetStringView(
+      this.context.pointer,
+      this.handle,
+      viewPtr
+    );
+    if (charsPtr !== 0) {
+      const length = memory.readUint32(viewPtr);
+      return memory.readUint32(viewPtr + 4) !== 0
+        ? memory.readUtf16(charsPtr, length)
+        : memory.readLatin1(charsPtr, length);
+    }
     const strPtr = this.context.container.exports.HAKO_ToCString(
       this.context.pointer,
       this.handle
@@ -503,57 +536,34 @@ export class VMValue implements Disposable {
    */
   getProperty(key: string | number | VMValue): VMValue {
     this.assertAlive();
-    return Scope.withScope((scope) => {
-      if (typeof key === "number") {
-        const propPtr = this.context.container.exports.HAKO_GetPropNumber(
-          this.context.pointer,
-          this.handle,
-          key
-        );
-        if (propPtr === 0) {
-          const error = this.context.getLastError();
-          if (error) {
-            throw error;
-          }
-        }
-        return new VMValue(this.context, propPtr, "owned");
-      }
-      let keyPtr: number;
-      if (typeof key === "string") {
-        const keyStrPtr = this.context.container.memory.allocateString(
-          this.context.pointer,
-          key
-        );
-        keyPtr = this.context.container.exports.HAKO_NewString(
-          this.context.pointer,
-          keyStrPtr
-        );
-        scope.add(() => {
-          this.context.container.memory.freeMemory(
-            this.context.pointer,
-            keyStrPtr
-          );
-          this.context.container.memory.freeValuePointer(
-            this.context.pointer,
-            keyPtr
-          );
-        });
-      } else {
-        keyPtr = key.getHandle();
-      }
-      const propPtr = this.context.container.exports.HAKO_GetProp(
+    const exports = this.context.container.exports;
+    let propPtr: JSValuePointer;
+    if (typeof key === "number") {
+      propPtr = exports.HAKO_GetPropNumber(
         this.context.pointer,
         this.handle,
-        keyPtr
+        key
       );
-      if (propPtr === 0) {
-        const error = this.context.getLastError();
-        if (error) {
-          throw error;
-        }
+    } else if (typeof key === "string") {
+      // String keys go through the context atom cache, so no key string is
+      // created for repeated property names
+      propPtr = this.context.withAtom(key, (atom) =>
+        exports.HAKO_GetPropAtom(this.context.pointer, this.handle, atom)
+      );
+    } else {
+      propPtr = exports.HAKO_GetProp(
+        this.context.pointer,
+        this.handle,
+        key.getHandle()
+      );
+    }
+    if (propPtr === 0) {
+      const error = this.context.getLastError();
+      if (error) {
+        throw error;
       }
-      return new VMValue(this.context, propPtr, "owned");
-    });
+    }
+    return new VMValue(this.context, propPtr, "owned");
   }
 
   /**
@@ -568,37 +578,60 @@ export class VMValue implements Disposable {
   setProperty(key: string | number | VMValue, value: unknown): boolean {
     this.assertAlive();
     return Scope.withScope((scope) => {
-      let keyPtr: number;
-      let valuePtr: number;
-
-      // Process the key
-      if (typeof key === "number") {
-        const keyValue = scope.manage(this.context.newValue(key));
-        keyPtr = keyValue.getHandle();
-      } else if (typeof key === "string") {
-        const keyValue = scope.manage(this.context.newValue(key));
-        keyPtr = keyValue.getHandle();
-      } else {
-        // For JSValue keys, just use the pointer
-        keyPtr = key.getHandle();
+      const exports = this.context.container.exports;
+
+      // Primitives are passed by value, without boxing them first
+      const raw = this.toRawPrimitive(value);
+      let valuePtr = 0;
+      if (raw === undefined) {
+        if (value instanceof VMValue) {
+          // For JSValue values, just use the pointer
+          valuePtr = value.getHandle();
+        } else {
+          // Convert JavaScript value to JSValue using the factory
+          const valueJSValue = scope.manage(this.context.newValue(value));
+          valuePtr = valueJSValue.getHandle();
+        }
       }
 
-      // Process the value
-      if (value instanceof VMValue) {
-        // For JSValue values, just use the pointer
-        valuePtr = value.getHandle();
+      let result: number;
+      if (typeof key === "string") {
+        // String keys go through the context atom cache
+        result = this.context.withAtom(key, (atom) =>
+          raw !== undefined
+            ? exports.HAKO_SetPropAtomRaw(
+                this.context.pointer,
+                this.handle,
+                atom,
+                raw
+              )
+            : exports.HAKO_SetPropAtom(
+                this.context.pointer,
+                this.handle,
+                atom,
+                valuePtr
+              )
+        );
       } else {
-        // Convert JavaScript value to JSValue using the factory
-        const valueJSValue = scope.manage(this.context.newValue(value));
-        valuePtr = valueJSValue.getHandle();
+        const keyPtr =
+          typeof key === "number"
+            ? scope.manage(this.context.newValue(key)).getHandle()
+            : key.getHandle();
+        result =
+          raw !== undefined
+            ? exports.HAKO_SetPropRaw(
+                this.context.pointer,
+                this.handle,
+                keyPtr,
+                raw
+              )
+            : exports.HAKO_SetProp(
+                this.context.pointer,
+                this.handle,
+                keyPtr,
+                valuePtr
+              );
       }
-      // Set the property
-      const result = this.context.container.exports.HAKO_SetProp(
-        this.context.pointer,
-        this.handle,
-        keyPtr,
-        valuePtr
-      );
       if (result === -1) {
         const error = this.context.getLastError();
         if (error) {
@@ -609,6 +642,145 @@ export class VMValue implements Disposable {
     });
   }
 
+  /**
+   * Gets several properties from this object in a single call.
+   *
+   * @param keys - Property names to read
+   * @returns The property values, in the same order as the keys
+   * @throws Error if any property access fails
+   * @throws {PrimJSUseAfterFree} If the value has been disposed
+   */
+  getProperties(keys: readonly string[]): VMValue[] {
+    this.assertAlive();
+    if (keys.length === 0) {
+      return [];
+    }
+    const ctx = this.context.pointer;
+    const { exports, memory, error } = this.context.container;
+    return this.context.withAtoms(keys, (atoms) =>
+      Scope.withScope((scope) => {
+        const count = keys.length;
+        const atomsPtr = memory.allocatePointerArray(ctx, count);
+        const valuesPtr = memory.allocatePointerArray(ctx, count);
+        const statusPtr = memory.allocateMemory(ctx, count);
+        scope.add(() => {
+          memory.freeMemory(ctx, atomsPtr);
+          memory.freeMemory(ctx, valuesPtr);
+          memory.freeMemory(ctx, statusPtr);
+        });
+        for (let i = 0; i < count; i++) {
+          memory.writePointerToArray(atomsPtr, i, atoms[i]);
+        }
+
+        const failures = exports.HAKO_GetProps(
+          ctx,
+          this.handle,
+          atomsPtr,
+          count,
+          valuesPtr,
+          statusPtr
+        );
+        const failed = memory.slice(statusPtr, count).indexOf(1);
+        const values = atoms.map(
+          (_, i) =>
+            new VMValue(
+              this.context,
+              memory.readPointerFromArray(valuesPtr, i),
+              "owned"
+            )
+        );
+        if (failures > 0) {
+          const exception = error.getExceptionDetails(
+            ctx,
+            values[failed].getHandle()
+          );
+          for (const value of values) {
+            value.dispose();
+          }
+          throw exception;
+        }
+        return values;
+      })
+    );
+  }
+
+  /**
+   * Sets several properties on this object in a single call.
+   *
+   * Every property is written even if an earlier one throws; the first
+   * error is rethrown afterwards.
+   *
+   * @param properties - Property names and the values to set
+   * @throws Error if any property assignment fails
+   * @throws {PrimJSUseAfterFree} If the value has been disposed
+   */
+  setProperties(properties: Record<string, unknown>): void {
+    this.assertAlive();
+    const keys = Object.keys(properties);
+    if (keys.length === 0) {
+      return;
+    }
+    const ctx = this.context.pointer;
+    const { exports, memory, error } = this.context.container;
+    this.context.withAtoms(keys, (atoms) =>
+      Scope.withScope((scope) => {
+        const count = keys.length;
+        const atomsPtr = memory.allocatePointerArray(ctx, count);
+        const valuesPtr = memory.allocateMemory(ctx, count * LEPUS_VALUE_SIZE);
+        const statusPtr = memory.allocateMemory(ctx, count);
+        const errorsPtr = memory.allocatePointerArray(ctx, count);
+        scope.add(() => {
+          memory.freeMemory(ctx, atomsPtr);
+          memory.freeMemory(ctx, valuesPtr);
+          memory.freeMemory(ctx, statusPtr);
+          memory.freeMemory(ctx, errorsPtr);
+        });
+
+        for (let i = 0; i < count; i++) {
+          memory.writePointerToArray(atomsPtr, i, atoms[i]);
+          const value = properties[keys[i]];
+          // Primitives are written by value, everything else is copied from
+          // its value pointer
+          const raw = this.toRawPrimitive(value);
+          if (raw !== undefined) {
+            memory.writeRawValueToArray(valuesPtr, i, raw);
+          } else {
+            const handle =
+              value instanceof VMValue
+                ? value.getHandle()
+                : scope.manage(this.context.newValue(value)).getHandle();
+            memory.writeValueArray(valuesPtr + i * LEPUS_VALUE_SIZE, [handle]);
+          }
+        }
+
+        const failures = exports.HAKO_SetProps(
+          ctx,
+          this.handle,
+          atomsPtr,
+          count,
+          valuesPtr,
+          statusPtr,
+          errorsPtr
+        );
+        if (failures === 0) {
+          return;
+        }
+        let exception: Error | undefined;
+        for (let i = 0; i < count; i++) {
+          const errorPtr = memory.readPointerFromArray(errorsPtr, i);
+          if (errorPtr === 0) {
+            continue;
+          }
+          exception ??= error.getExceptionDetails(ctx, errorPtr);
+          memory.freeValuePointer(ctx, errorPtr);
+        }
+        if (exception) {
+          throw exception;
+        }
+      })
+    );
+  }
+
   /**
    * Defines a property with a property descriptor on this object.
    *
@@ -624,15 +796,6 @@ export class VMValue implements Disposable {
   ): boolean {
     this.assertAlive();
     return Scope.withScope((scope) => {
-      let keyPtr: number;
-
-      if (typeof key === "string") {
-        const keyStr = scope.manage(this.context.newValue(key));
-        keyPtr = keyStr.getHandle();
-      } else {
-        keyPtr = key.getHandle();
-      }
-
       // Set up descriptor parameters
       let valuePtr = this.context.container.exports.HAKO_GetUndefined();
       let getPtr = this.context.container.exports.HAKO_GetUndefined();
@@ -668,17 +831,33 @@ export class VMValue implements Disposable {
         }
       }
 
-      const result = this.context.container.exports.HAKO_DefineProp(
-        this.context.pointer,
-        this.handle,
-        keyPtr,
-        valuePtr,
-        getPtr,
-        setPtr,
-        configurable ? 1 : 0,
-        enumerable ? 1 : 0,
-        hasValue ? 1 : 0
-      );
+      const exports = this.context.container.exports;
+      const result =
+        typeof key === "string"
+          ? this.context.withAtom(key, (atom) =>
+              exports.HAKO_DefinePropAtom(
+                this.context.pointer,
+                this.handle,
+                atom,
+                valuePtr,
+                getPtr,
+                setPtr,
+                configurable ? 1 : 0,
+                enumerable ? 1 : 0,
+                hasValue ? 1 : 0
+              )
+            )
+          : exports.HAKO_DefineProp(
+              this.context.pointer,
+              this.handle,
+              key.getHandle(),
+              valuePtr,
+              getPtr,
+              setPtr,
+              configurable ? 1 : 0,
+              enumerable ? 1 : 0,
+              hasValue ? 1 : 0
+            );
       if (result === -1) {
         const error = this.context.getLastError();
         if (error) {
@@ -791,6 +970,58 @@ export class VMValue implements Disposable {
     scope.release();
   }
 
+  /**
+   * Gets own string and integer property keys of this object in one call.
+   *
+   * Unlike {@link getOwnPropertyNames} the keys are decoded from a single
+   * packed buffer, without a value handle per key. Symbol keys are skipped.
+   *
+   * @param flags - Flags to control which properties to include
+   * @returns The property keys, integer keys as numbers
+   * @throws Error if property enumeration fails
+   * @throws {PrimJSUseAfterFree} If the value has been disposed
+   */
+  getOwnPropertyKeys(
+    flags: PropertyEnumFlags = PROPERTY_ENUM_STRING | PROPERTY_ENUM_ENUMERABLE
+  ): Array<string | number> {
+    this.assertAlive();
+    const ctx = this.context.pointer;
+    const { exports, memory } = this.context.container;
+    const lenPtr = this.context.scratchCell();
+    const bufPtr = exports.HAKO_GetOwnPropertyNamesPacked(
+      ctx,
+      this.handle,
+      flags & ~PROPERTY_ENUM_SYMBOL,
+      PACK_KEY_UTF8,
+      lenPtr
+    );
+    if (bufPtr === 0) {
+      const error = this.context.getLastError();
+      throw error ?? new HakoError("Failed to get property names");
+    }
+    // Decoded in place; nothing below calls into the VM until the free
+    const bytes = memory.slice(bufPtr, memory.readUint32(lenPtr));
+    const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.length);
+    const count = view.getUint32(0, true);
+    const keys: Array<string | number> = new Array(count);
+    let offset = 4;
+    for (let i = 0; i < count; i++) {
+      const kind = view.getUint8(offset);
+      const slot = view.getUint32(offset + 1, true);
+      offset += 5;
+      if (kind === PACKED_KEY_INDEX) {
+        keys[i] = slot;
+      } else {
+        const length = view.getUint32(offset, true);
+        offset += 4;
+        keys[i] = memory.readUtf8(bufPtr + offset, length);
+        offset += length;
+      }
+    }
+    memory.freeMemory(ctx, bufPtr);
+    return keys;
+  }
+
   /**
    * Gets the promise state if this value is a promise.
    *
@@ -915,15 +1146,20 @@ export class VMValue implements Disposable {
   /**
    * Converts this VM value to a native JavaScript value.
    *
-   * Handles all JavaScript types including objects and arrays (recursively).
+   * Handles all JavaScript types including objects and arrays. Object graphs
+   * are serialized inside the VM and decoded in a single pass; shared and
+   * cyclic references are preserved.
    * Returns a NativeBox that contains the value and implements the Disposable interface.
    *
    * @template TValue - The expected type of the native value
+   * @param options - Depth, size and cycle limits for object graphs
    * @returns A NativeBox containing the native value
    * @throws Error if conversion fails
    * @throws {PrimJSUseAfterFree} If the value has been disposed
    */
-  toNativeValue<TValue = unknown>(): NativeBox<TValue> {
+  toNativeValue<TValue = unknown>(
+    options: NativeGraphOptions = {}
+  ): NativeBox<TValue> {
     this.assertAlive();
     const type = this.type;
     const disposables: Disposable[] = [];
@@ -963,38 +1199,23 @@ export class VMValue implements Disposable {
           if (this.isNull()) {
             return createResult(null);
           }
-          if (this.isArray()) {
-            const length = this.getLength();
-            const result = [];
-            for (let i = 0; i < length; i++) {
-              const item = this.getProperty(i).toNativeValue();
-
+          return createResult(
+            this.toNativeGraph(options, (pointer) => {
+              const item = new VMValue(
+                this.context,
+                pointer,
+                "owned"
+              ).toNativeValue();
               disposables.push(item);
-              result.push(item.value);
-            }
-            return createResult(result);
-          }
-
-          const result: Record<string, unknown> = {};
-          const ownProps = this.getOwnPropertyNames();
-          let iterationResult = ownProps.next();
-          try {
-            while (!iterationResult.done) {
-              const prop = iterationResult.value;
-              const propName = prop.consume((v) => v.asString());
-              const value = this.getProperty(propName).toNativeValue();
-              disposables.push(value);
-              result[propName] = value.value;
-              iterationResult = ownProps.next();
-            }
-            return createResult(result);
-          } catch (error) {
-            // Pass the error to the generator, allowing it to handle internally
-            ownProps.throw(error);
-            throw error;
-          }
+              return item.value;
+            })
+          );
         }
         case "function": {
+          // The wrapper outlives any value scope the walk runs in
+          while (this.valueScope) {
+            this.context.promoteValue(this);
+          }
           const jsFunction = (...args: unknown[]): unknown => {
             return Scope.withScope((scope) => {
               const jsArgs = args.map((arg) =>
@@ -1029,6 +1250,42 @@ export class VMValue implements Disposable {
     }
   }
 
+  /**
+   * Serializes this object graph inside the VM and decodes it on the host.
+   *
+   * @private
+   * @param options - Depth, size and cycle limits
+   * @param opaque - Converts values that have no data representation
+   * @returns The decoded host value
+   */
+  private toNativeGraph(
+    options: NativeGraphOptions,
+    opaque: (pointer: JSValuePointer) => unknown
+  ): unknown {
+    const ctx = this.context.pointer;
+    const { exports, memory } = this.context.container;
+    return Scope.withScope((scope) => {
+      const outLenPtr = memory.allocateMemory(ctx, 4);
+      scope.add(() => memory.freeMemory(ctx, outLenPtr));
+      const bufPtr = exports.HAKO_ToNative(
+        ctx,
+        this.handle,
+        options.maxDepth ?? 0,
+        options.maxBytes ?? 0,
+        options.rejectCycles ? NATIVE_FLAG_REJECT_CYCLES : 0,
+        outLenPtr
+      );
+      if (bufPtr === 0) {
+        const error = this.context.getLastError();
+        throw error ?? new HakoError("Failed to convert value graph");
+      }
+      // Copy out before decoding, opaque conversions may grow the memory
+      const bytes = memory.copy(bufPtr, memory.readUint32(outLenPtr));
+      memory.freeMemory(ctx, bufPtr);
+      return decodeNativeGraph(bytes, opaque);
+    });
+  }
+
   /**
    * Extracts the data from a Uint8Array typed array.
    *
@@ -1150,6 +1407,13 @@ export class VMValue implements Disposable {
       this.handle = 0;
       return;
     }
+    if (this.valueScope) {
+      // Freed in bulk when the value scope is popped
+      this.valueScope.delete(this);
+      this.valueScope = undefined;
+      this.handle = 0;
+      return;
+    }
     this.context.container.memory.freeValuePointer(
       this.context.pointer,
       this.handle
@@ -1157,6 +1421,26 @@ export class VMValue implements Disposable {
     this.handle = 0;
   }
 
+  /**
+   * Reassigns the native value scope responsible for freeing this value.
+   *
+   * @param scope - The new owning scope, or undefined if unscoped
+   * @internal
+   */
+  moveToValueScope(scope: Set<VMValue> | undefined): void {
+    this.valueScope = scope;
+  }
+
+  /**
+   * Invalidates this value after its native value scope has freed it.
+   *
+   * @internal
+   */
+  detachFromValueScope(): void {
+    this.valueScope = undefined;
+    this.handle = 0;
+  }
+
   /**
    * Implements Symbol.dispose for the Disposable interface.
    *
@@ -1332,6 +1616,27 @@ export class VMValue implements Disposable {
     );
   }
 
+  /**
+   * Converts a host number, boolean, null or undefined into a raw value.
+   *
+   * @private
+   * @param value - The host value to convert
+   * @returns The raw value, or undefined if the value is not such a primitive
+   */
+  private toRawPrimitive(value: unknown): JSValueRaw | undefined {
+    const exports = this.context.container.exports;
+    switch (typeof value) {
+      case "number":
+        return exports.HAKO_NewFloat64Raw(this.context.pointer, value);
+      case "boolean":
+        return exports.HAKO_NewBoolRaw(this.context.pointer, value ? 1 : 0);
+      case "undefined":
+        return exports.HAKO_GetUndefinedRaw();
+      default:
+        return value === null ? exports.HAKO_GetNullRaw() : undefined;
+    }
+  }
+
   /**
    * Verifies that this value is still alive (not disposed).
    *
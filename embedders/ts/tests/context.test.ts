@@ -1,7 +1,18 @@
 import { afterEach, beforeEach, describe, expect, it } from "bun:test";
 import { createHakoRuntime, decodeVariant, HAKO_PROD } from "../src";
 import type { HakoExports } from "../src/etc/ffi";
-import type { ModuleLoaderFunction, TraceEvent } from "../src/etc/types";
+import {
+  BATCH_OP_CALL,
+  BATCH_OP_EXPORT,
+  BATCH_OP_GET,
+  BATCH_OP_LOAD,
+  BATCH_OP_LOAD_INT,
+  BATCH_OP_LOAD_STRING,
+  BATCH_OP_TYPEOF,
+  type ModuleLoaderFunction,
+  type TraceEvent,
+} from "../src/etc/types";
+import { encodeByteCodeBundle } from "../src/helpers/bytecode-bundle";
 import type { HakoRuntime } from "../src/host/runtime";
 import { DisposableResult } from "../src/mem/lifetime";
 import type { MemoryManager } from "../src/mem/memory";
@@ -149,6 +160,342 @@ describe("JSContext", () => {
     exports.HAKO_SetContextData(context.pointer, 0);
   });
 
+  it("should detect stale value handles", () => {
+    const exports: HakoExports = context.container.exports;
+
+    const valuePtr = exports.HAKO_NewFloat64(context.pointer, 42);
+    const handle = exports.HAKO_ValueToHandle(context.pointer, valuePtr);
+    expect(handle).not.toBe(0);
+    expect(exports.HAKO_HandleToValue(context.pointer, handle)).toBe(valuePtr);
+
+    exports.HAKO_FreeValuePointer(context.pointer, valuePtr);
+    expect(exports.HAKO_HandleToValue(context.pointer, handle)).toBe(0);
+    expect(exports.HAKO_FreeHandle(context.pointer, handle)).toBe(0);
+
+    // The freed slot is recycled with a new generation
+    const reusedPtr = exports.HAKO_NewFloat64(context.pointer, 7);
+    expect(reusedPtr).toBe(valuePtr);
+    const reusedHandle = exports.HAKO_ValueToHandle(context.pointer, reusedPtr);
+    expect(reusedHandle).not.toBe(handle);
+    expect(exports.HAKO_FreeHandle(context.pointer, reusedHandle)).toBe(1);
+  });
+
+  it("should free values in bulk when a value scope is popped", () => {
+    const exports: HakoExports = context.container.exports;
+    const before = exports.HAKO_GetLiveHandleCount(runtime.pointer);
+
+    let temporary: VMValue | undefined;
+    const kept = context.withValueScope(() => {
+      temporary = context.newNumber(1);
+      context.newString("leaked without dispose");
+      return context.promoteValue(context.newNumber(2));
+    });
+
+    expect(temporary?.alive).toBe(false);
+    expect(kept.alive).toBe(true);
+    expect(kept.asNumber()).toBe(2);
+    expect(exports.HAKO_GetLiveHandleCount(runtime.pointer)).toBe(before + 1);
+
+    kept.dispose();
+    expect(exports.HAKO_GetLiveHandleCount(runtime.pointer)).toBe(before);
+  });
+
+  it("should keep value scopes separate per context", () => {
+    const other = runtime.createContext();
+    try {
+      let outside: VMValue | undefined;
+      context.withValueScope(() => {
+        outside = other.newString("created in another context");
+        context.newNumber(1);
+      });
+      expect(outside?.alive).toBe(true);
+      expect(outside?.asString()).toBe("created in another context");
+      outside?.dispose();
+    } finally {
+      other.release();
+    }
+  });
+
+  it("should execute a batch of operations in one call", () => {
+    const mem: MemoryManager = context.container.memory;
+    const exports: HakoExports = context.container.exports;
+    using global = context.getGlobalObject();
+    const math = mem.allocateString(context.pointer, "Math");
+    const max = mem.allocateString(context.pointer, "max");
+    // biome-ignore format: one instruction per line
+    const ops = [
+      BATCH_OP_LOAD, 0, global.getHandle(),
+      BATCH_OP_LOAD_STRING, 1, math,
+      BATCH_OP_GET, 2, 0, 1,
+      BATCH_OP_LOAD_STRING, 1, max,
+      BATCH_OP_GET, 3, 2, 1,
+      BATCH_OP_LOAD_INT, 4, 3,
+      BATCH_OP_LOAD_INT, 5, 7,
+      BATCH_OP_CALL, 6, 3, 2, 2, 4, 5,
+      BATCH_OP_TYPEOF, 3,
+      BATCH_OP_EXPORT, 6,
+    ];
+    const opsPtr = mem.allocatePointerArray(context.pointer, ops.length);
+    ops.forEach((op, i) => mem.writePointerToArray(opsPtr, i, op));
+    const outPtr = mem.allocatePointerArray(context.pointer, 2);
+
+    const error = exports.HAKO_ExecBatch(
+      context.pointer,
+      opsPtr,
+      ops.length,
+      7,
+      outPtr,
+      2
+    );
+    expect(error).toBe(0);
+    expect(mem.readPointerFromArray(outPtr, 0)).toBe(7); // HAKO_TYPE_FUNCTION
+    using result = new VMValue(
+      context,
+      mem.readPointerFromArray(outPtr, 1),
+      "owned"
+    );
+    expect(result.asNumber()).toBe(7);
+
+    for (const ptr of [math, max, opsPtr, outPtr]) {
+      mem.freeMemory(context.pointer, ptr);
+    }
+  });
+
+  it("should pass primitives by value", () => {
+    const exports: HakoExports = context.container.exports;
+    const raw = exports.HAKO_NewFloat64Raw(context.pointer, 42.5);
+    expect(typeof raw).toBe("bigint");
+    expect(exports.HAKO_GetFloat64Raw(context.pointer, raw)).toBe(42.5);
+    expect(exports.HAKO_TypeOfRaw(context.pointer, raw)).toBe(5);
+    expect(exports.HAKO_IsNullRaw(exports.HAKO_GetNullRaw())).toBe(1);
+    expect(exports.HAKO_IsUndefinedRaw(exports.HAKO_GetUndefinedRaw())).toBe(1);
+
+    using obj = context.newObject();
+    obj.setProperty("n", 7);
+    obj.setProperty("b", true);
+    obj.setProperty("z", null);
+    using n = obj.getProperty("n");
+    using b = obj.getProperty("b");
+    using z = obj.getProperty("z");
+    expect(n.asNumber()).toBe(7);
+    expect(b.asBoolean()).toBe(true);
+    expect(z.isNull()).toBe(true);
+    expect(exports.HAKO_ValueToRaw(n.getHandle())).toBe(
+      exports.HAKO_NewFloat64Raw(context.pointer, 7)
+    );
+  });
+
+  it("should keep arguments intact across re-entrant calls", () => {
+    using inner = context.evalCode("(a, b) => a * b").unwrap();
+    using outer = context.newFunction("outer", (...values) => {
+      using two = context.newNumber(2);
+      using product = context
+        .callFunction(inner, null, values[values.length - 1], two)
+        .unwrap();
+      return product.dup();
+    });
+    using sum = context
+      .evalCode(
+        "(f) => (...args) => f(...args) + args.reduce((x, y) => x + y, 0)"
+      )
+      .unwrap();
+    using wrapped = context.callFunction(sum, null, outer).unwrap();
+
+    const args = Array.from({ length: 10 }, (_, i) => context.newNumber(i + 1));
+    using result = context.callFunction(wrapped, null, ...args).unwrap();
+    expect(result.asNumber()).toBe(20 + 55);
+    for (const arg of args) {
+      arg.dispose();
+    }
+  });
+
+  it("should call functions with more arguments than the scratch argv", () => {
+    using count = context.evalCode("(...args) => args.length").unwrap();
+    using one = context.newNumber(1);
+    const args = Array.from({ length: 2000 }, () => one);
+    using result = context.callFunction(count, null, ...args).unwrap();
+    expect(result.asNumber()).toBe(2000);
+  });
+
+  it("should access properties through interned atoms", () => {
+    const mem: MemoryManager = context.container.memory;
+    const exports: HakoExports = context.container.exports;
+    using obj = context.evalCode("({ headers: { type: 'json' } })").unwrap();
+
+    const { pointer, length } = mem.writeNullTerminatedString(
+      context.pointer,
+      "headers"
+    );
+    const atom = exports.HAKO_NewAtom(context.pointer, pointer, length - 1);
+    mem.freeMemory(context.pointer, pointer);
+    expect(atom).not.toBe(0);
+
+    for (let i = 0; i < 3; i++) {
+      using headers = new VMValue(
+        context,
+        exports.HAKO_GetPropAtom(context.pointer, obj.getHandle(), atom),
+        "owned"
+      );
+      using type = headers.getProperty("type");
+      expect(type.asString()).toBe("json");
+    }
+    exports.HAKO_FreeAtom(context.pointer, atom);
+
+    obj.setProperty("count", 3);
+    obj.defineProperty("hidden", { value: "x", enumerable: false });
+    using count = obj.getProperty("count");
+    using hidden = obj.getProperty("hidden");
+    expect(count.asNumber()).toBe(3);
+    expect(hidden.asString()).toBe("x");
+  });
+
+  it("should read and write several properties at once", () => {
+    using obj = context
+      .evalCode(`({
+        a: 1,
+        b: "two",
+        get broken() { throw new Error("getter failed"); },
+        set locked(v) { throw new Error("setter failed"); },
+      })`)
+      .unwrap();
+
+    const [a, b] = obj.getProperties(["a", "b"]);
+    expect(a.asNumber()).toBe(1);
+    expect(b.asString()).toBe("two");
+    a.dispose();
+    b.dispose();
+
+    expect(() => obj.getProperties(["a", "broken"])).toThrow("getter failed");
+
+    using nested = context.newObject();
+    obj.setProperties({ c: true, d: null, e: "five", f: nested });
+    using c = obj.getProperty("c");
+    using d = obj.getProperty("d");
+    using e = obj.getProperty("e");
+    expect(c.asBoolean()).toBe(true);
+    expect(d.isNull()).toBe(true);
+    expect(e.asString()).toBe("five");
+
+    expect(() => obj.setProperties({ locked: 1, g: 2 })).toThrow(
+      "setter failed"
+    );
+    using g = obj.getProperty("g");
+    expect(g.asNumber()).toBe(2);
+  });
+
+  it("should list own property keys from a packed buffer", () => {
+    using obj = context
+      .evalCode(`({ b: 1, "ключ": 2, [Symbol("s")]: 3 })`)
+      .unwrap();
+    expect(obj.getOwnPropertyKeys()).toEqual(["b", "ключ"]);
+
+    using many = context
+      .evalCode(`Object.fromEntries(
+        Array.from({ length: 1500 }, (_, i) => ["k" + i, i]))`)
+      .unwrap();
+    const keys = many.getOwnPropertyKeys();
+    expect(keys.length).toBe(1500);
+    expect(keys[1499]).toBe("k1499");
+    const names = [...many.getOwnPropertyNames()];
+    expect(names.length).toBe(1500);
+    for (const name of names) name.dispose();
+  });
+
+  it("should run a prepared script many times", () => {
+    using script = context
+      .prepareScript("this.runs = (this.runs ?? 0) + 1; this.runs * 10")
+      .unwrap();
+
+    for (let i = 1; i <= 3; i++) {
+      using result = context.runPrepared(script).unwrap();
+      expect(result.asNumber()).toBe(i * 10);
+    }
+
+    using target = context.newObject();
+    using own = context.runPrepared(script, target).unwrap();
+    expect(own.asNumber()).toBe(10);
+
+    const broken = context.prepareScript("let = ;");
+    expect(broken.error).toBeDefined();
+    broken.dispose();
+
+    using notScript = context.newNumber(1);
+    const bad = context.runPrepared(notScript);
+    expect(bad.error).toBeDefined();
+    bad.dispose();
+  });
+
+  it("should evaluate a source buffered in chunks", () => {
+    const encoder = new TextEncoder();
+    const buffer = context.createEvalBuffer();
+    buffer.append("const greeting = '");
+    // Split a multi-byte character across two chunks
+    const bytes = encoder.encode("héllo';");
+    buffer.append(bytes.subarray(0, 2));
+    buffer.append(bytes.subarray(2));
+    buffer.append(" greeting.length + ':' + greeting");
+
+    using result = buffer.end().unwrap();
+    expect(result.asString()).toBe("5:héllo");
+    expect(buffer.alive).toBe(false);
+    expect(() => buffer.append("1")).toThrow();
+
+    const broken = context.createEvalBuffer(16);
+    broken.append("let = ;");
+    const failed = broken.end();
+    expect(failed.error).toBeDefined();
+    failed.dispose();
+
+    using aborted = context.createEvalBuffer();
+    aborted.append("1 + 1");
+  });
+
+  it("should convert object graphs in one pass", () => {
+    using obj = context
+      .evalCode(`
+        const shared = { n: 1.5, big: 2n };
+        const root = { list: [shared, shared, "x", true, null], fn() {} };
+        root.self = root;
+        root;
+      `)
+      .unwrap();
+
+    using box = obj.toNativeValue<any>();
+    const root = box.value;
+    expect(root.list[0]).toEqual({ n: 1.5, big: 2n });
+    expect(root.list[0]).toBe(root.list[1]);
+    expect(root.list.slice(2)).toEqual(["x", true, null]);
+    expect(root.self).toBe(root);
+    expect(typeof root.fn).toBe("function");
+
+    using cyclic = context.evalCode("const c = {}; c.c = c; c").unwrap();
+    expect(() => cyclic.toNativeValue({ rejectCycles: true })).toThrow();
+    using deep = context.evalCode("({ a: { b: { c: {} } } })").unwrap();
+    expect(() => deep.toNativeValue({ maxDepth: 2 })).toThrow();
+
+    // Getter results are freed during the walk; objects created later at the
+    // same address must not be written as references to them
+    using fresh = context
+      .evalCode(
+        `const fresh = {};
+         for (const key of ["a", "b", "c", "d"]) {
+           Object.defineProperty(fresh, key, {
+             enumerable: true,
+             get: () => ({ key }),
+           });
+         }
+         fresh;`
+      )
+      .unwrap();
+    using freshBox = fresh.toNativeValue<any>();
+    expect(freshBox.value).toEqual({
+      a: { key: "a" },
+      b: { key: "b" },
+      c: { key: "c" },
+      d: { key: "d" },
+    });
+  });
+
   describe("Code evaluation", () => {
     it("should evaluate simple JavaScript expressions", () => {
       using result = context.evalCode("1 + 2");
@@ -1464,6 +1811,20 @@ fibonacci(100);
       expect(result.asNumber()).toBe(25);
     });
 
+    it("should evaluate pinned bytecode repeatedly", () => {
+      using compileResult = context.compileToByteCode("6 * 7");
+      using pinned = runtime.pinByteCode(compileResult.unwrap());
+
+      for (let i = 0; i < 3; i++) {
+        using result = context.evalByteCode(pinned).unwrap();
+        expect(result.asNumber()).toBe(42);
+      }
+
+      pinned.dispose();
+      expect(pinned.alive).toBe(false);
+      expect(() => context.evalByteCode(pinned)).toThrow();
+    });
+
     it("should compile and evaluate an ES6 module", () => {
       const code = `
       export const test = "Hello, World!";
@@ -1503,6 +1864,51 @@ fibonacci(100);
       expect(callResultValue.asNumber()).toBe(10);
     });
 
+    it("should import modules from a bytecode bundle", () => {
+      // Compile in a separate context so the modules are not already
+      // registered in the one that imports them
+      const compiler = runtime.createContext();
+      const math = compiler
+        .compileToByteCode("export const add = (a, b) => a + b;", {
+          type: "module",
+          fileName: "math.js",
+        })
+        .unwrap();
+      const unused = compiler
+        .compileToByteCode("export default 1;", {
+          type: "module",
+          fileName: "unused.js",
+        })
+        .unwrap();
+      compiler.release();
+
+      const bundle = encodeByteCodeBundle([
+        { name: "file://math.js", bytecode: math },
+        { name: "file://unused.js", bytecode: unused },
+      ]);
+
+      expect(runtime.loadBundle(bundle)).toBe(2);
+      expect(() => runtime.loadBundle(bundle.subarray(0, 20))).toThrow();
+
+      const requested: string[] = [];
+      runtime.enableModuleLoader((name) => {
+        requested.push(name);
+        return null;
+      });
+
+      using result = context.evalCode(
+        `import { add } from "file://math.js"; export const sum = add(2, 3);`,
+        { type: "module" }
+      );
+      using namespace = result.unwrap();
+      using sum = namespace.getProperty("sum");
+      expect(sum.asNumber()).toBe(5);
+      expect(requested).toEqual([]);
+
+      runtime.unloadBundles();
+      runtime.disableModuleLoader();
+    });
+
     it("should handle auto-detection of modules", () => {
       const moduleCode = `
       export const greeting = "Hello, World!";
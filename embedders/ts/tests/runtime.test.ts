@@ -2,6 +2,7 @@ import { afterEach, beforeEach, describe, expect, it } from "bun:test";
 import { createHakoRuntime, decodeVariant, HAKO_PROD } from "../src";
 import type { ModuleLoaderFunction } from "../src/etc/types";
 import type { HakoRuntime } from "../src/host/runtime";
+import type { VMContext } from "../src/vm/context";
 
 describe("JSRuntime", () => {
   let runtime: HakoRuntime;
@@ -51,6 +52,54 @@ describe("JSRuntime", () => {
     expect(() => runtime.setMemoryLimit(memoryLimit)).not.toThrow();
   });
 
+  it("should reuse compiled scripts across contexts", () => {
+    runtime.setScriptCacheLimit(1024 * 1024);
+    const source = "globalThis.counter = (globalThis.counter ?? 0) + 1";
+
+    const first = runtime.createContext();
+    const second = runtime.createContext();
+    try {
+      first.evalCode(source).unwrap().dispose();
+      first.evalCode(source).unwrap().dispose();
+      second.evalCode(source).unwrap().dispose();
+
+      using counter = first.evalCode("counter").unwrap();
+      expect(counter.asNumber()).toBe(2);
+
+      const stats = runtime.getScriptCacheStats();
+      expect(stats.misses).toBeGreaterThanOrEqual(1);
+      expect(stats.hits).toBeGreaterThanOrEqual(2);
+      expect(stats.entries).toBeGreaterThanOrEqual(1);
+      expect(stats.limit).toBe(1024 * 1024);
+    } finally {
+      first.release();
+      second.release();
+    }
+
+    runtime.purgeScriptCache();
+    expect(runtime.getScriptCacheStats().entries).toBe(0);
+    runtime.setScriptCacheLimit(0);
+    expect(runtime.getScriptCacheStats().limit).toBe(0);
+  });
+
+  it("should not reuse cached scripts compiled with other strip flags", () => {
+    runtime.setScriptCacheLimit(1024 * 1024);
+    const strip = runtime.getStripInfo();
+    const context = runtime.createContext();
+    try {
+      context.evalCode("1 + 1").unwrap().dispose();
+      const misses = runtime.getScriptCacheStats().misses;
+
+      runtime.setStripInfo({ stripSource: true });
+      context.evalCode("1 + 1").unwrap().dispose();
+      expect(runtime.getScriptCacheStats().misses).toBe(misses + 1);
+    } finally {
+      runtime.setStripInfo(strip);
+      context.release();
+      runtime.setScriptCacheLimit(0);
+    }
+  });
+
   it("should compute memory usage", () => {
     const memoryUsage = runtime.computeMemoryUsage();
 
@@ -163,6 +212,175 @@ describe("JSRuntime", () => {
     }).not.toThrow();
   });
 
+  it("should share versioned modules across contexts", () => {
+    let source = "export const value = 1;";
+    runtime.enableModuleLoader(() => ({
+      type: "source",
+      data: source,
+      version: "v1",
+    }));
+
+    const readValue = () => {
+      const context = runtime.createContext();
+      try {
+        using result = context.evalCode(
+          `import { value } from "lib"; export const seen = value;`,
+          { type: "module" }
+        );
+        using namespace = result.unwrap();
+        using seen = namespace.getProperty("seen");
+        return seen.asNumber();
+      } finally {
+        context.release();
+      }
+    };
+
+    expect(readValue()).toBe(1);
+
+    // Same version: later contexts reuse the module compiled first
+    source = "export const value = 2;";
+    expect(readValue()).toBe(1);
+
+    runtime.invalidateModuleCache("lib");
+    expect(readValue()).toBe(2);
+
+    runtime.invalidateModuleCache();
+    runtime.disableModuleLoader();
+  });
+
+  it("should prefetch an import graph through the module loader", () => {
+    const sources: Record<string, string> = {
+      "lib/a.js": `import { c } from "./c.js"; export const a = c + 1;`,
+      "lib/b.js": `import { c } from "./c.js"; export const b = c + 2;`,
+      "lib/c.js": `export const c = 10;`,
+    };
+    const requested: string[] = [];
+    runtime.enableModuleLoader((name) => {
+      requested.push(name);
+      return name in sources ? { type: "source", data: sources[name] } : null;
+    });
+    runtime.setModulePrefetch(true);
+
+    const context = runtime.createContext();
+    try {
+      using result = context.evalCode(
+        `import { a } from "lib/a.js";
+         import { b } from "lib/b.js";
+         export const total = a + b;`,
+        { type: "module" }
+      );
+      using namespace = result.unwrap();
+      using total = namespace.getProperty("total");
+      expect(total.asNumber()).toBe(23);
+      expect(requested.sort()).toEqual(["lib/a.js", "lib/b.js", "lib/c.js"]);
+    } finally {
+      context.release();
+      runtime.setModulePrefetch(false);
+      runtime.disableModuleLoader();
+    }
+  });
+
+  it("should not prefetch registered modules", () => {
+    runtime.registerModule("lib/shared.js", "export const shared = 5;");
+    const requested: string[] = [];
+    runtime.enableModuleLoader((name) => {
+      requested.push(name);
+      return name === "lib/main.js"
+        ? {
+            type: "source",
+            data: `import { shared } from "./shared.js";
+                   export const main = shared * 2;`,
+          }
+        : null;
+    });
+    runtime.setModulePrefetch(true);
+
+    const context = runtime.createContext();
+    try {
+      using result = context.evalCode(
+        `import { main } from "lib/main.js"; export const value = main;`,
+        { type: "module" }
+      );
+      using namespace = result.unwrap();
+      using value = namespace.getProperty("value");
+      expect(value.asNumber()).toBe(10);
+      expect(requested).toEqual(["lib/main.js"]);
+    } finally {
+      context.release();
+      runtime.setModulePrefetch(false);
+      runtime.disableModuleLoader();
+      runtime.unregisterModule("lib/shared.js");
+    }
+  });
+
+  it("should import registered modules without a module loader", () => {
+    runtime.registerModule("math", "export const double = (x) => x * 2;");
+    runtime.registerModule("greeting", `export default "hello";`);
+
+    const importValue = () => {
+      const context = runtime.createContext();
+      try {
+        using result = context.evalCode(
+          `import { double } from "math";
+           import greeting from "greeting";
+           export const value = greeting + double(21);`,
+          { type: "module" }
+        );
+        using namespace = result.unwrap();
+        using value = namespace.getProperty("value");
+        return value.asString();
+      } finally {
+        context.release();
+      }
+    };
+
+    try {
+      expect(importValue()).toBe("hello42");
+      expect(importValue()).toBe("hello42");
+
+      runtime.registerModule("greeting", `export default "bye";`);
+      expect(importValue()).toBe("bye42");
+    } finally {
+      runtime.unregisterModule("math");
+      runtime.unregisterModule("greeting");
+      runtime.disableModuleLoader();
+    }
+  });
+
+  it("should reset and reuse pooled contexts per key", () => {
+    using pool = runtime.createContextPool({
+      prelude: (context) => {
+        using _ = context.evalCode(`globalThis.shared = 1;`).unwrap();
+      },
+    });
+    const evalString = (context: VMContext, code: string) => {
+      using result = context.evalCode(code);
+      using value = result.unwrap();
+      return value.asString();
+    };
+
+    const first = pool.acquire("tenant-a");
+    evalString(first, `globalThis.added = 1; JSON = null; shared = 2; "ok"`);
+    first.setOpaqueData("tenant-a");
+    pool.release(first);
+    expect(pool.idleCount).toBe(1);
+
+    const other = pool.acquire("tenant-b");
+    expect(other).not.toBe(first);
+    pool.release(other);
+
+    const again = pool.acquire("tenant-a");
+    expect(again).toBe(first);
+    expect(evalString(again, `typeof added`)).toBe("undefined");
+    expect(evalString(again, `typeof JSON.parse`)).toBe("function");
+    expect(evalString(again, `String(shared)`)).toBe("1");
+    expect(again.getOpaqueData()).toBeUndefined();
+
+    evalString(again, `var declared = 1; "ok"`);
+    expect(again.reset()).toBe(1);
+    pool.release(again);
+  });
+
   it("should enable and disable interrupt handler", () => {
     const handler = () => false; // Never interrupt
 
@@ -4,7 +4,7 @@ import { HakoError } from "../src/etc/errors";
 import type { HostCallbackFunction } from "../src/etc/types";
 import type { HakoRuntime } from "../src/host/runtime";
 import type { VMContext } from "../src/vm/context";
-import type { VMValue } from "../src/vm/value";
+import { VMValue } from "../src/vm/value";
 
 describe("ValueFactory", () => {
   let runtime: HakoRuntime;
@@ -112,6 +112,78 @@ describe("ValueFactory", () => {
     });
   });
 
+  describe("String encodings", () => {
+    it("should read strings through a view of their characters", () => {
+      const ascii = "log line ".repeat(1000);
+      using big = context.newValue(ascii);
+      expect(big.asString()).toBe(ascii);
+
+      using nul = context.newValue("a\0b ✓");
+      expect(nul.asString()).toBe("a\0b ✓");
+
+      // 8-bit characters outside ASCII, including the C1 range
+      using latin1 = context.newValue("café \u0085\u00ff");
+      expect(latin1.asString()).toBe("café \u0085\u00ff");
+
+      using wide = context.newValue("emoji 😀 ✓");
+      expect(wide.asString()).toBe("emoji 😀 ✓");
+
+      // Concatenation may produce a rope, which is flattened on read
+      using rope = context
+        .evalCode(`let s = ""; for (let i = 0; i < 100; i++) s += i + "✓"; s`)
+        .unwrap();
+      let expected = "";
+      for (let i = 0; i < 100; i++) expected += `${i}✓`;
+      expect(rope.asString()).toBe(expected);
+      expect(rope.asString()).toBe(expected);
+
+      using num = context.newValue(42);
+      expect(num.asString()).toBe("42");
+    });
+
+    it("should transfer strings as UTF-16 and Latin-1", () => {
+      const { exports, memory } = context.container;
+      const ctx = context.pointer;
+      const text = "héllo 👋 \ud800";
+
+      const units = Uint16Array.from(text, (_, i) => text.charCodeAt(i));
+      const utf16Ptr = memory.allocateMemory(ctx, units.byteLength);
+      new Uint16Array(exports.memory.buffer, utf16Ptr, units.length).set(units);
+      using fromUtf16 = new VMValue(
+        context,
+        exports.HAKO_NewStringUTF16(ctx, utf16Ptr, units.length),
+        "owned"
+      );
+      memory.freeMemory(ctx, utf16Ptr);
+
+      const required = exports.HAKO_GetStringUTF16(
+        ctx,
+        fromUtf16.getHandle(),
+        0,
+        0
+      );
+      expect(required).toBe(text.length);
+      const outPtr = memory.allocateMemory(ctx, required * 2);
+      exports.HAKO_GetStringUTF16(ctx, fromUtf16.getHandle(), outPtr, required);
+      const out = new Uint16Array(exports.memory.buffer, outPtr, required);
+      expect(String.fromCharCode(...out)).toBe(text);
+      memory.freeMemory(ctx, outPtr);
+
+      const latin1Ptr = memory.writeBytes(ctx, new Uint8Array([0x63, 0xe9]));
+      using fromLatin1 = new VMValue(
+        context,
+        exports.HAKO_NewStringLatin1(ctx, latin1Ptr, 2),
+        "owned"
+      );
+      memory.freeMemory(ctx, latin1Ptr);
+      expect(fromLatin1.asString()).toBe("cé");
+      expect(
+        exports.HAKO_GetStringLatin1(ctx, fromUtf16.getHandle(), 0, 0)
+      ).toBe(-1);
+      expect(context.getLastError()?.message).toContain("Latin-1");
+    });
+  });
+
   // Object Tests
   describe("Objects", () => {
     it("should create empty object", () => {
@@ -576,6 +648,30 @@ describe("ValueFactory", () => {
       expect(name1.asString()).toBe("Item 2");
     });
 
+    it("should create a graph with shared references in one call", () => {
+      const shared = { tag: "shared" };
+      using date = context.newValue(new Date(0));
+      using obj = context.newValue({
+        rows: [
+          { id: 1, ratio: 0.5, big: 10n, at: date, shared },
+          { id: 2, ratio: -0, big: -10n, at: date, shared },
+        ],
+        created: new Date(0),
+      });
+
+      using check = context
+        .evalCode(
+          `(o) => o.rows[0].shared === o.rows[1].shared &&
+            o.rows[1].at === o.rows[0].at &&
+            o.rows[1].big === -10n &&
+            Object.is(o.rows[1].ratio, -0) &&
+            o.created instanceof Date`
+        )
+        .unwrap();
+      using result = context.callFunction(check, null, obj).unwrap();
+      expect(result.asBoolean()).toBe(true);
+    });
+
     it("should catch circular reference", () => {
       const obj: any = { name: "circular" };
       obj.self = obj; // circular reference
@@ -0,0 +1,331 @@
+#!/usr/bin/env zx
+import { path, fs } from "zx";
+import { createHakoRuntime } from "../src/index";
+
+/**
+ * Pre-initializes a Hako WASM module, in the spirit of Wizer
+ *
+ * Instantiates the module, creates a runtime and a template context, runs an
+ * init script in that context and writes a new module whose data segments
+ * already hold the initialized heap. createHakoRuntime adopts the captured
+ * runtime and HakoRuntime.getPreinitializedContext returns the context, so
+ * instances skip runtime creation, context creation and the init script.
+ *
+ * The init script must not depend on host state that is not in linear
+ * memory: host functions, module loaders and interrupt handlers registered
+ * from JavaScript are not carried over.
+ *
+ * Usage: bun tools/preinitialize.ts <input.wasm> <init.js> <output.wasm>
+ */
+
+const PAGE_SIZE = 65536;
+// Engines reject modules with more data segments than this
+const MAX_DATA_SEGMENTS = 100000;
+
+const SECTION_IMPORT = 2;
+const SECTION_EXPORT = 7;
+const SECTION_CODE = 10;
+const SECTION_DATA = 11;
+const SECTION_DATA_COUNT = 12;
+const EXTERNAL_MEMORY = 2;
+
+const [inputPath, initPath, outputPath] = process.argv.slice(-3);
+if (!inputPath?.endsWith(".wasm") || !outputPath?.endsWith(".wasm")) {
+  console.error(
+    "Usage: bun tools/preinitialize.ts <input.wasm> <init.js> <output.wasm>"
+  );
+  process.exit(1);
+}
+
+class Reader {
+  offset = 0;
+  constructor(readonly bytes: Uint8Array) {}
+
+  byte(): number {
+    return this.bytes[this.offset++];
+  }
+
+  u32(): number {
+    let result = 0;
+    let shift = 0;
+    let byte: number;
+    do {
+      byte = this.byte();
+      result += (byte & 0x7f) * 2 ** shift;
+      shift += 7;
+    } while (byte & 0x80);
+    return result;
+  }
+
+  take(length: number): Uint8Array {
+    const slice = this.bytes.subarray(this.offset, this.offset + length);
+    this.offset += length;
+    return slice;
+  }
+
+  name(): string {
+    return new TextDecoder().decode(this.take(this.u32()));
+  }
+}
+
+function u32(value: number): number[] {
+  const out: number[] = [];
+  do {
+    let byte = value % 128;
+    value = Math.floor(value / 128);
+    if (value > 0) byte |= 0x80;
+    out.push(byte);
+  } while (value > 0);
+  return out;
+}
+
+function i32(value: number): number[] {
+  const out: number[] = [];
+  value |= 0;
+  while (true) {
+    const byte = value & 0x7f;
+    value >>= 7;
+    if ((value === 0 && !(byte & 0x40)) || (value === -1 && byte & 0x40)) {
+      out.push(byte);
+      return out;
+    }
+    out.push(byte | 0x80);
+  }
+}
+
+function section(id: number, payload: Uint8Array): Uint8Array {
+  const header = [id, ...u32(payload.length)];
+  const out = new Uint8Array(header.length + payload.length);
+  out.set(header);
+  out.set(payload, header.length);
+  return out;
+}
+
+function concat(parts: (Uint8Array | number[])[]): Uint8Array {
+  const length = parts.reduce((sum, part) => sum + part.length, 0);
+  const out = new Uint8Array(length);
+  let offset = 0;
+  for (const part of parts) {
+    out.set(part, offset);
+    offset += part.length;
+  }
+  return out;
+}
+
+/**
+ * Finds the non-zero ranges of memory, merging ranges separated by fewer
+ * than minGap zero bytes since each segment costs a few bytes of header
+ */
+function findSegments(
+  image: Uint8Array,
+  minGap: number
+): Array<[number, number]> {
+  const segments: Array<[number, number]> = [];
+  let i = 0;
+  while (i < image.length) {
+    while (i < image.length && image[i] === 0) i++;
+    if (i === image.length) break;
+    const start = i;
+    let end = i;
+    while (i < image.length && i - end < minGap) {
+      if (image[i] !== 0) end = i + 1;
+      i++;
+    }
+    segments.push([start, end]);
+  }
+  return segments;
+}
+
+/**
+ * Rewrites the import section so the memory import requires at least the
+ * captured number of pages
+ */
+function rewriteImports(payload: Uint8Array, minPages: number): Uint8Array {
+  const reader = new Reader(payload);
+  const count = reader.u32();
+  const parts: (Uint8Array | number[])[] = [u32(count)];
+  for (let i = 0; i < count; i++) {
+    const start = reader.offset;
+    reader.name();
+    reader.name();
+    const kind = reader.byte();
+    if (kind !== EXTERNAL_MEMORY) {
+      switch (kind) {
+        case 0: // function
+          reader.u32();
+          break;
+        case 1: {
+          // table
+          reader.byte();
+          const flags = reader.byte();
+          reader.u32();
+          if (flags & 1) reader.u32();
+          break;
+        }
+        case 3: // global
+          reader.take(2);
+          break;
+        case 4: // tag
+          reader.byte();
+          reader.u32();
+          break;
+        default:
+          throw new Error(`Unknown import kind ${kind}`);
+      }
+      parts.push(payload.subarray(start, reader.offset));
+      continue;
+    }
+    parts.push(payload.subarray(start, reader.offset));
+    const flags = reader.byte();
+    if (flags > 1) {
+      throw new Error("Shared and 64-bit memories are not supported");
+    }
+    const min = reader.u32();
+    const limits = [flags, ...u32(Math.max(min, minPages))];
+    if (flags & 1) {
+      const max = reader.u32();
+      if (max < minPages) {
+        throw new Error(`Captured heap exceeds maximum memory (${max} pages)`);
+      }
+      limits.push(...u32(max));
+    }
+    parts.push(limits);
+  }
+  return concat(parts);
+}
+
+/**
+ * Drops the _initialize export so that static constructors do not run again
+ * over the captured heap
+ */
+function rewriteExports(payload: Uint8Array): Uint8Array {
+  const reader = new Reader(payload);
+  const count = reader.u32();
+  const kept: Uint8Array[] = [];
+  for (let i = 0; i < count; i++) {
+    const start = reader.offset;
+    const name = reader.name();
+    reader.byte();
+    reader.u32();
+    if (name !== "_initialize") {
+      kept.push(payload.subarray(start, reader.offset));
+    }
+  }
+  return concat([u32(kept.length), ...kept]);
+}
+
+/**
+ * Rejects data sections with passive segments, which code may still refer to
+ * through memory.init
+ */
+function checkData(payload: Uint8Array): void {
+  const reader = new Reader(payload);
+  const count = reader.u32();
+  for (let i = 0; i < count; i++) {
+    const flags = reader.u32();
+    if (flags === 1) {
+      throw new Error("Modules with passive data segments are not supported");
+    }
+    if (flags === 2) reader.u32();
+    // Constant offset expression: opcode, LEB128 immediate, end
+    reader.byte();
+    while (reader.byte() & 0x80) {}
+    reader.byte();
+    reader.take(reader.u32());
+  }
+}
+
+function encodeData(
+  image: Uint8Array,
+  segments: Array<[number, number]>
+): Uint8Array {
+  const parts: (Uint8Array | number[])[] = [u32(segments.length)];
+  for (const [start, end] of segments) {
+    // Active segment of memory 0 at i32.const start
+    parts.push([0, 0x41, ...i32(start), 0x0b, ...u32(end - start)]);
+    parts.push(image.subarray(start, end));
+  }
+  return concat(parts);
+}
+
+function rewriteModule(
+  module: Uint8Array,
+  image: Uint8Array,
+  segments: Array<[number, number]>
+): Uint8Array {
+  const reader = new Reader(module);
+  const parts: Uint8Array[] = [reader.take(8)];
+  const pages = image.length / PAGE_SIZE;
+  while (reader.offset < module.length) {
+    const id = reader.byte();
+    const payload = reader.take(reader.u32());
+    switch (id) {
+      case SECTION_IMPORT:
+        parts.push(section(id, rewriteImports(payload, pages)));
+        break;
+      case SECTION_EXPORT:
+        parts.push(section(id, rewriteExports(payload)));
+        break;
+      case SECTION_CODE:
+        parts.push(section(id, payload));
+        // The captured image replaces the original data section
+        parts.push(section(SECTION_DATA, encodeData(image, segments)));
+        break;
+      case SECTION_DATA:
+        checkData(payload);
+        break;
+      case SECTION_DATA_COUNT:
+        parts.push(section(id, new Uint8Array(u32(segments.length))));
+        break;
+      default:
+        parts.push(section(id, payload));
+    }
+  }
+  return concat(parts);
+}
+
+const input = new Uint8Array(await fs.readFile(inputPath));
+const initScript = await fs.readFile(initPath, "utf-8");
+
+// Same limits as createHakoRuntime's defaults (24MB initial, 256MB maximum)
+const memory = new WebAssembly.Memory({ initial: 384, maximum: 4096 });
+const runtime = await createHakoRuntime({
+  loader: { binary: input },
+  wasm: { memory: { byom: memory } },
+});
+if (runtime.getPreinitializedContext()) {
+  console.error(`❌ ${inputPath} is already pre-initialized`);
+  process.exit(1);
+}
+
+const context = runtime.createContext();
+try {
+  using _ = context
+    .evalCode(initScript, { fileName: path.basename(initPath) })
+    .unwrap();
+} catch (error) {
+  console.error("❌ Init script threw:", error);
+  process.exit(1);
+}
+runtime.executePendingJobs();
+runtime.markPreinitialized(context);
+
+const image = new Uint8Array(memory.buffer);
+let minGap = 32;
+let segments = findSegments(image, minGap);
+while (segments.length > MAX_DATA_SEGMENTS) {
+  minGap *= 2;
+  segments = findSegments(image, minGap);
+}
+
+const output = rewriteModule(input, image, segments);
+await fs.writeFile(outputPath, output);
+
+const capturedKB = Math.round(
+  segments.reduce((sum, [start, end]) => sum + end - start, 0) / 1024
+);
+console.log(`✅ Pre-initialized module written to ${outputPath}`);
+console.log(
+  `   ${segments.length} data segments, ${capturedKB} KB of heap, ` +
+    `${image.length / PAGE_SIZE} pages of memory required`
+);
@@ -208,10 +208,12 @@ class TypeScriptInterfaceGenerator:
             "import type {",
             "    CString,",
             "    HAKOTypeOf,",
+            "    JSAtom,",
             "    JSContextPointer,",
             "    JSRuntimePointer,",
             "    JSValueConstPointer,",
             "    JSValuePointer,",
+            "    JSValueRaw,",
             "    LEPUS_BOOL,",
             "    LEPUSModuleDef,",
             "} from './types';",